@@ -126,6 +126,21 @@ void BlameWidget::onNewRevisions(int totalCommits)
    mRepoModel->onNewRevisions(totalCommits);
 }
 
+void BlameWidget::onRevisionsAboutToBeInserted(int firstRow, int count)
+{
+   mRepoModel->onRevisionsAboutToBeInserted(firstRow, count);
+}
+
+void BlameWidget::onRevisionsInserted(int firstRow, int count)
+{
+   mRepoModel->onRevisionsInserted(firstRow, count);
+}
+
+void BlameWidget::onRevisionsUpdated(int firstRow, int lastRow)
+{
+   mRepoModel->onRevisionsUpdated(firstRow, lastRow);
+}
+
 void BlameWidget::reloadBlame(const QModelIndex &index)
 {
    mSelectedRow = index.row();
@@ -53,6 +53,9 @@ public:
    void showFileHistory(const QModelIndex &index);
    void showFileHistory(const QString &filePath);
    void onNewRevisions(int totalCommits);
+   void onRevisionsAboutToBeInserted(int firstRow, int count);
+   void onRevisionsInserted(int firstRow, int count);
+   void onRevisionsUpdated(int firstRow, int lastRow);
 
 private:
    QSharedPointer<RevisionsCache> mCache;
@@ -86,6 +86,9 @@ GitQlientRepo::GitQlientRepo(const QString &repoPath, QWidget *parent)
    connect(mHistoryWidget, &HistoryWidget::signalShowFileHistory, this, &GitQlientRepo::showFileHistory);
    connect(mHistoryWidget, &HistoryWidget::signalOpenFileCommit, this, &GitQlientRepo::loadFileDiff);
    connect(mHistoryWidget, &HistoryWidget::signalUpdateWip, this, &GitQlientRepo::updateWip);
+   connect(mHistoryWidget, &HistoryWidget::signalLoadMoreCommits, mGitLoader.get(), &GitRepoLoader::loadNextPage);
+   connect(mHistoryWidget, &HistoryWidget::signalDetailsRequested, mGitLoader.get(),
+           &GitRepoLoader::loadCommitDetails);
 
    connect(mDiffWidget, &DiffWidget::signalShowFileHistory, this, &GitQlientRepo::showFileHistory);
    connect(mDiffWidget, &DiffWidget::signalDiffEmpty, mControls, &Controls::disableDiff);
@@ -95,11 +98,22 @@ GitQlientRepo::GitQlientRepo(const QString &repoPath, QWidget *parent)
 
    connect(mGitLoader.get(), &GitRepoLoader::signalLoadingStarted, this, &GitQlientRepo::updateProgressDialog,
            Qt::DirectConnection);
+   connect(mGitLoader.get(), &GitRepoLoader::signalNewRevisions, this, &GitQlientRepo::onNewRevisions,
+           Qt::DirectConnection);
+   connect(mGitLoader.get(), &GitRepoLoader::signalRevisionsAboutToBeInserted, this,
+           &GitQlientRepo::onRevisionsAboutToBeInserted, Qt::DirectConnection);
+   connect(mGitLoader.get(), &GitRepoLoader::signalRevisionsInserted, this, &GitQlientRepo::onRevisionsInserted,
+           Qt::DirectConnection);
+   connect(mGitLoader.get(), &GitRepoLoader::signalRevisionsUpdated, this, &GitQlientRepo::onRevisionsUpdated,
+           Qt::DirectConnection);
    connect(mGitLoader.get(), &GitRepoLoader::signalLoadingFinished, this, &GitQlientRepo::onRepoLoadFinished,
            Qt::DirectConnection);
+   connect(mGitLoader.get(), &GitRepoLoader::signalReloadRequired, this, &GitQlientRepo::reloadRepository,
+           Qt::DirectConnection);
 
    GitQlientSettings settings;
    mGitLoader->setShowAll(settings.value("ShowAllBranches", true).toBool());
+   mGitLoader->setPageSize(settings.value("historyPageSize", 0).toInt());
 
    setRepository(repoPath);
 }
@@ -131,9 +145,11 @@ void GitQlientRepo::updateCache()
    {
       QLog_Debug("UI", QString("Updating the GitQlient UI"));
 
-      mHistoryWidget->clear();
-
-      mGitLoader->loadRepository();
+      // When possible only the new commits are loaded and the history keeps the rows it already has
+      if (mGitLoader->refreshRepository())
+         mHistoryWidget->clearDetails();
+      else
+         reloadRepository();
 
       mHistoryWidget->reload();
 
@@ -141,6 +157,12 @@ void GitQlientRepo::updateCache()
    }
 }
 
+void GitQlientRepo::reloadRepository()
+{
+   mHistoryWidget->clear();
+   mGitLoader->loadRepository();
+}
+
 void GitQlientRepo::updateUiFromWatcher()
 {
    QLog_Info("UI", QString("Updating the GitQlient UI from watcher"));
@@ -280,16 +302,46 @@ void GitQlientRepo::updateProgressDialog()
    }
 }
 
-void GitQlientRepo::onRepoLoadFinished()
+void GitQlientRepo::onNewRevisions(int totalCommits)
 {
-   mProgressDlg->close();
-
-   const auto totalCommits = mGitQlientCache->count();
+   // The first batch of commits is enough to let the user work while the rest of the history is loaded
+   if (mProgressDlg)
+      mProgressDlg->close();
 
    mHistoryWidget->onNewRevisions(totalCommits);
    mBlameWidget->onNewRevisions(totalCommits);
 }
 
+void GitQlientRepo::onRevisionsAboutToBeInserted(int firstRow, int count)
+{
+   mHistoryWidget->onRevisionsAboutToBeInserted(firstRow, count);
+   mBlameWidget->onRevisionsAboutToBeInserted(firstRow, count);
+}
+
+void GitQlientRepo::onRevisionsInserted(int firstRow, int count)
+{
+   mHistoryWidget->onRevisionsInserted(firstRow, count);
+   mBlameWidget->onRevisionsInserted(firstRow, count);
+}
+
+void GitQlientRepo::onRevisionsUpdated(int firstRow, int lastRow)
+{
+   mHistoryWidget->onRevisionsUpdated(firstRow, lastRow);
+   mBlameWidget->onRevisionsUpdated(firstRow, lastRow);
+}
+
+void GitQlientRepo::onRepoLoadFinished()
+{
+   if (mProgressDlg)
+      mProgressDlg->close();
+
+   mHistoryWidget->onLoadingFinished();
+
+   // The bodies are only read again when the index starts over, not after every refresh
+   if (mGitQlientCache->buildSearchIndex())
+      mGitLoader->loadCommitBodies();
+}
+
 void GitQlientRepo::loadFileDiff(const QString &currentSha, const QString &previousSha, const QString &file)
 {
    const auto loaded = mDiffWidget->loadFileDiff(currentSha, previousSha, file);
@@ -91,6 +91,7 @@ private:
    QPair<ControlsMainViews, QWidget *> mPreviousView;
 
    void updateCache();
+   void reloadRepository();
    void updateUiFromWatcher();
    void openCommitDiff();
    void openCommitCompareDiff(const QStringList &shas);
@@ -101,6 +102,10 @@ private:
    void executeCommand();
    void showFileHistory(const QString &fileName);
    void updateProgressDialog();
+   void onNewRevisions(int totalCommits);
+   void onRevisionsAboutToBeInserted(int firstRow, int count);
+   void onRevisionsInserted(int firstRow, int count);
+   void onRevisionsUpdated(int firstRow, int lastRow);
    void onRepoLoadFinished();
    void loadFileDiff(const QString &currentSha, const QString &previousSha, const QString &file);
    void showHistoryView();
@@ -2,6 +2,7 @@
 
 #include <CommitHistoryModel.h>
 #include <CommitHistoryView.h>
+#include <CommitFilterBar.h>
 #include <RepositoryViewDelegate.h>
 #include <BranchesWidget.h>
 #include <WorkInProgressWidget.h>
@@ -15,6 +16,8 @@
 
 #include <QGridLayout>
 #include <QLineEdit>
+#include <QPushButton>
+#include <QShortcut>
 #include <QStackedWidget>
 #include <QCheckBox>
 
@@ -27,8 +30,10 @@ HistoryWidget::HistoryWidget(const QSharedPointer<RevisionsCache> &cache, const
    , mCache(cache)
    , mRepositoryModel(new CommitHistoryModel(mCache, git))
    , mRepositoryView(new CommitHistoryView(mCache, git))
-   , mBranchesWidget(new BranchesWidget(git))
+   , mBranchesWidget(new BranchesWidget(mCache, git))
    , mSearchInput(new QLineEdit())
+   , mFilterBtn(new QPushButton(tr("Filter")))
+   , mFilterBar(new CommitFilterBar())
    , mCommitStackedWidget(new QStackedWidget())
    , mCommitWidget(new WorkInProgressWidget(mCache, git))
    , mRevisionWidget(new CommitInfoWidget(mCache, git))
@@ -50,8 +55,24 @@ HistoryWidget::HistoryWidget(const QSharedPointer<RevisionsCache> &cache, const
    connect(mRevisionWidget, &CommitInfoWidget::signalOpenFileCommit, this, &HistoryWidget::signalOpenFileCommit);
    connect(mRevisionWidget, &CommitInfoWidget::signalShowFileHistory, this, &HistoryWidget::signalShowFileHistory);
 
-   mSearchInput->setPlaceholderText(tr("Press Enter to search by SHA or log message..."));
-   connect(mSearchInput, &QLineEdit::returnPressed, this, &HistoryWidget::search);
+   mSearchInput->setPlaceholderText(
+       tr("Press Enter to search by SHA, log message or author (Shift+Enter goes to the previous result)..."));
+   connect(mSearchInput, &QLineEdit::returnPressed, this, [this]() { search(false); });
+
+   // The line edit doesn't take Shift+Enter, so the shortcuts get it before returnPressed is emitted
+   for (const auto key : { Qt::Key_Return, Qt::Key_Enter })
+   {
+      const auto shortcut = new QShortcut(QKeySequence(Qt::SHIFT + key), mSearchInput, nullptr, nullptr,
+                                          Qt::WidgetShortcut);
+      connect(shortcut, &QShortcut::activated, this, [this]() { search(true); });
+   }
+   connect(mSearchInput, &QLineEdit::textChanged, this, &HistoryWidget::onSearchTextChanged);
+
+   mFilterBtn->setCheckable(true);
+   mFilterBar->setVisible(false);
+   connect(mFilterBtn, &QPushButton::toggled, this, &HistoryWidget::onFilterToggled);
+   connect(mFilterBar, &CommitFilterBar::signalFilterChanged, mRepositoryView, &CommitHistoryView::filterCommits);
+   connect(mRepositoryView, &CommitHistoryView::signalFilterFinished, mFilterBar, &CommitFilterBar::setMatches);
 
    mRepositoryView->setModel(mRepositoryModel);
    mRepositoryView->setItemDelegate(mItemDelegate = new RepositoryViewDelegate(cache, git, mRepositoryView));
@@ -63,6 +84,8 @@ HistoryWidget::HistoryWidget(const QSharedPointer<RevisionsCache> &cache, const
    connect(mRepositoryView, &CommitHistoryView::clicked, this, &HistoryWidget::commitSelected);
    connect(mRepositoryView, &CommitHistoryView::doubleClicked, this, &HistoryWidget::openDiff);
    connect(mRepositoryView, &CommitHistoryView::signalAmendCommit, this, &HistoryWidget::onAmendCommit);
+   connect(mRepositoryView, &CommitHistoryView::signalLoadMoreCommits, this, &HistoryWidget::signalLoadMoreCommits);
+   connect(mRepositoryView, &CommitHistoryView::signalDetailsRequested, this, &HistoryWidget::signalDetailsRequested);
 
    connect(mBranchesWidget, &BranchesWidget::signalBranchesUpdated, this, &HistoryWidget::signalUpdateCache);
    connect(mBranchesWidget, &BranchesWidget::signalBranchCheckedOut, this, &HistoryWidget::onBranchCheckout);
@@ -81,12 +104,14 @@ HistoryWidget::HistoryWidget(const QSharedPointer<RevisionsCache> &cache, const
    graphOptionsLayout->setContentsMargins(QMargins());
    graphOptionsLayout->setSpacing(10);
    graphOptionsLayout->addWidget(mSearchInput);
+   graphOptionsLayout->addWidget(mFilterBtn);
    graphOptionsLayout->addWidget(mChShowAllBranches);
 
    const auto viewLayout = new QVBoxLayout();
    viewLayout->setContentsMargins(QMargins());
    viewLayout->setSpacing(5);
    viewLayout->addLayout(graphOptionsLayout);
+   viewLayout->addWidget(mFilterBar);
    viewLayout->addWidget(mRepositoryView);
 
    const auto layout = new QHBoxLayout();
@@ -108,6 +133,11 @@ HistoryWidget::~HistoryWidget()
 void HistoryWidget::clear()
 {
    mRepositoryView->clear();
+   clearDetails();
+}
+
+void HistoryWidget::clearDetails()
+{
    resetWip();
    mBranchesWidget->clear();
    mRevisionWidget->clear();
@@ -156,36 +186,91 @@ void HistoryWidget::onNewRevisions(int totalCommits)
    mRepositoryModel->onNewRevisions(totalCommits);
 }
 
-void HistoryWidget::search()
+void HistoryWidget::onRevisionsAboutToBeInserted(int firstRow, int count)
+{
+   mRepositoryModel->onRevisionsAboutToBeInserted(firstRow, count);
+}
+
+void HistoryWidget::onRevisionsInserted(int firstRow, int count)
+{
+   mRepositoryModel->onRevisionsInserted(firstRow, count);
+}
+
+void HistoryWidget::onRevisionsUpdated(int firstRow, int lastRow)
+{
+   mRepositoryModel->onRevisionsUpdated(firstRow, lastRow);
+}
+
+void HistoryWidget::onLoadingFinished()
+{
+   // The pages are requested when scrolling, so the first ones must fill the view
+   mRepositoryView->fillViewport();
+}
+
+void HistoryWidget::search(bool backwards)
 {
    const auto text = mSearchInput->text();
 
    if (!text.isEmpty())
    {
-      auto commitInfo = mCache->getCommitInfo(text);
+      const auto match = mCache->findCommitByPrefix(text.trimmed());
 
-      if (commitInfo.isValid())
-         goToSha(text);
-      else
+      // The full SHA is used since the other widgets don't resolve abbreviations
+      if (match.isUnique())
       {
-         auto selectedItems = mRepositoryView->selectedIndexes();
-         auto startingRow = 0;
+         mRepositoryView->setHighlightedCommits({});
+         goToSha(mCache->getCommitIdByRow(match.row).toHex());
+         return;
+      }
+
+      if (match.isAmbiguous())
+         QLog_Info("UI", QString("More than one commit starts by {%1}, searching it in the messages.").arg(text));
 
-         if (!selectedItems.isEmpty())
-         {
-            std::sort(selectedItems.begin(), selectedItems.end(),
-                      [](const QModelIndex index1, const QModelIndex index2) { return index1.row() <= index2.row(); });
-            startingRow = selectedItems.constFirst().row();
-         }
+      const auto rows = mCache->findCommits(text);
+      QSet<ObjectId> ids;
 
-         commitInfo = mCache->getCommitInfoByField(CommitInfo::Field::SHORT_LOG, text, startingRow + 1);
+      for (const auto row : rows)
+         ids.insert(mCache->getCommitIdByRow(row));
 
-         if (commitInfo.isValid())
-            goToSha(commitInfo.sha());
+      mRepositoryView->setHighlightedCommits(ids);
+
+      if (rows.isEmpty())
+         return;
+
+      auto selectedItems = mRepositoryView->selectedIndexes();
+      auto startingRow = 0;
+
+      if (!selectedItems.isEmpty())
+      {
+         std::sort(selectedItems.begin(), selectedItems.end(),
+                   [](const QModelIndex index1, const QModelIndex index2) { return index1.row() <= index2.row(); });
+         startingRow = selectedItems.constFirst().row();
+      }
+
+      // Enter goes to the next result and Shift+Enter to the previous one, both wrap around
+      int row;
+
+      if (backwards)
+      {
+         const auto previous = std::lower_bound(rows.cbegin(), rows.cend(), startingRow);
+         row = previous != rows.cbegin() ? *(previous - 1) : rows.constLast();
+      }
+      else
+      {
+         const auto next = std::upper_bound(rows.cbegin(), rows.cend(), startingRow);
+         row = next != rows.cend() ? *next : rows.constFirst();
       }
+
+      goToSha(mCache->getCommitIdByRow(row).toHex());
    }
 }
 
+void HistoryWidget::onSearchTextChanged(const QString &text)
+{
+   if (text.isEmpty())
+      mRepositoryView->setHighlightedCommits({});
+}
+
 void HistoryWidget::goToSha(const QString &sha)
 {
    mRepositoryView->focusOnCommit(sha);
@@ -215,13 +300,23 @@ void HistoryWidget::onShowAllUpdated(bool showAll)
    emit signalAllBranchesActive(showAll);
 }
 
-void HistoryWidget::onBranchCheckout()
+void HistoryWidget::onFilterToggled(bool showFilter)
 {
-   QScopedPointer<GitBranches> gitBranches(new GitBranches(mGit));
-   const auto ret = gitBranches->getLastCommitOfBranch(mGit->getCurrentBranch());
+   mFilterBar->setVisible(showFilter);
 
+   // The filter only applies while the bar is shown
+   if (!showFilter)
+      mFilterBar->clear();
+}
+
+void HistoryWidget::onBranchCheckout()
+{
    if (mChShowAllBranches->isChecked())
-      mRepositoryView->focusOnCommit(ret.output.toString());
+   {
+      QScopedPointer<GitBranches> gitBranches(new GitBranches(mGit));
+      gitBranches->requestLastCommitOfBranch(mGit->getCurrentBranch(), this,
+                                             [this](const QString &sha) { mRepositoryView->focusOnCommit(sha); });
+   }
 
    emit signalUpdateCache();
 }
@@ -12,6 +12,8 @@ class QStackedWidget;
 class WorkInProgressWidget;
 class CommitInfoWidget;
 class QCheckBox;
+class QPushButton;
+class CommitFilterBar;
 class RepositoryViewDelegate;
 
 class HistoryWidget : public QFrame
@@ -31,12 +33,15 @@ signals:
    void signalOpenFileCommit(const QString &currentSha, const QString &previousSha, const QString &file);
    void signalAllBranchesActive(bool showAll);
    void signalUpdateWip();
+   void signalLoadMoreCommits();
+   void signalDetailsRequested(int firstRow, int lastRow);
 
 public:
    explicit HistoryWidget(const QSharedPointer<RevisionsCache> &cache, const QSharedPointer<GitBase> git,
                           QWidget *parent = nullptr);
    ~HistoryWidget();
    void clear();
+   void clearDetails();
    void resetWip();
    void reload();
    void updateUiFromWatcher();
@@ -45,6 +50,10 @@ public:
    void onAmendCommit(const QString &sha);
    QString getCurrentSha() const;
    void onNewRevisions(int totalCommits);
+   void onRevisionsAboutToBeInserted(int firstRow, int count);
+   void onRevisionsInserted(int firstRow, int count);
+   void onRevisionsUpdated(int firstRow, int lastRow);
+   void onLoadingFinished();
 
 private:
    QSharedPointer<GitBase> mGit;
@@ -53,16 +62,21 @@ private:
    CommitHistoryView *mRepositoryView = nullptr;
    BranchesWidget *mBranchesWidget = nullptr;
    QLineEdit *mSearchInput = nullptr;
+   QPushButton *mFilterBtn = nullptr;
+   CommitFilterBar *mFilterBar = nullptr;
    QStackedWidget *mCommitStackedWidget = nullptr;
    WorkInProgressWidget *mCommitWidget = nullptr;
    CommitInfoWidget *mRevisionWidget = nullptr;
    QCheckBox *mChShowAllBranches = nullptr;
    RepositoryViewDelegate *mItemDelegate = nullptr;
 
-   void search();
+   // Goes to the next result of the search, or to the previous one going backwards
+   void search(bool backwards);
+   void onSearchTextChanged(const QString &text);
    void goToSha(const QString &sha);
    void commitSelected(const QModelIndex &index);
    void openDiff(const QModelIndex &index);
    void onShowAllUpdated(bool showAll);
+   void onFilterToggled(bool showFilter);
    void onBranchCheckout();
 };
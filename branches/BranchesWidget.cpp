@@ -1,8 +1,12 @@
 #include "BranchesWidget.h"
 
 #include <BranchTreeWidget.h>
+#include <CommitStore.h>
+#include <GitAsync.h>
+#include <GitBase.h>
 #include <GitBranches.h>
 #include <GitTags.h>
+#include <RevisionsCache.h>
 #include <GitSubmodules.h>
 #include <GitStashes.h>
 #include <BranchesViewDelegate.h>
@@ -20,6 +24,8 @@
 
 #include <QLogger.h>
 
+#include <algorithm>
+
 using namespace QLogger;
 
 namespace
@@ -41,8 +47,10 @@ QTreeWidgetItem *getChild(QTreeWidgetItem *parent, const QString &childName)
 }
 }
 
-BranchesWidget::BranchesWidget(const QSharedPointer<GitBase> &git, QWidget *parent)
+BranchesWidget::BranchesWidget(const QSharedPointer<RevisionsCache> &cache, const QSharedPointer<GitBase> &git,
+                               QWidget *parent)
    : QFrame(parent)
+   , mCache(cache)
    , mGit(git)
    , mLocalBranchesTree(new BranchTreeWidget(mGit))
    , mRemoteBranchesTree(new BranchTreeWidget(mGit))
@@ -208,44 +216,113 @@ void BranchesWidget::showBranches()
 {
    QLog_Info("UI", QString("Loading branches data"));
 
-   clear();
+   // Only the answer of the last request is shown
+   const auto request = ++mLoadRequest;
+
+   // The store is implicitly shared, so the copy doesn't change while the history is loaded in this thread
+   const auto loadedCommits = mCache->commits();
+   const auto task = [loadedCommits](const QSharedPointer<GitBase> &git) {
+      return loadBranchesInfo(git, loadedCommits);
+   };
 
-   QApplication::setOverrideCursor(QCursor(Qt::WaitCursor));
-   QScopedPointer<GitBranches> git(new GitBranches(mGit));
-   auto ret = git->getBranches();
+   runGitAsync(mGit, task, this, [this, request](const BranchesInfo &info) {
+      if (request == mLoadRequest)
+         onBranchesInfoLoaded(info);
+   });
+}
 
-   if (ret.success)
+BranchesWidget::BranchesInfo BranchesWidget::loadBranchesInfo(const QSharedPointer<GitBase> &git,
+                                                              const CommitStore &loadedCommits)
+{
+   BranchesInfo info;
+   QVector<BranchInfo> branches;
+
+   info.success = GitBranches(git).getBranchesInfo("origin/master", branches, loadedCommits);
+
+   if (info.success)
    {
-      auto output = ret.output.toString();
-      if (!output.startsWith("fatal"))
-      {
-         output.replace(' ', "");
-         const auto branches = output.split('\n');
+      QLog_Info("UI", QString("Fetched {%1} branches").arg(branches.count()));
 
-         QLog_Info("UI", QString("Fetched {%1} branches").arg(branches.count()));
-         QLog_Info("UI", QString("Processing branches..."));
+      const auto isDetached = std::none_of(branches.cbegin(), branches.cend(), [](const BranchInfo &branch) {
+         return branch.isCurrent;
+      });
 
-         mRemoteBranchesTree->addTopLevelItem(new QTreeWidgetItem({ "origin" }));
+      if (isDetached)
+      {
+         const auto ret = git->runCached("git rev-parse --short HEAD");
 
-         for (const auto &branch : branches)
+         if (ret.first)
          {
-            if (!branch.isEmpty())
-            {
-               if (branch.startsWith("remotes/") && !branch.contains("HEAD->"))
-                  processRemoteBranch(branch);
-               else if (!branch.contains("HEAD->"))
-                  processLocalBranch(branch);
-            }
+            LocalBranch detached;
+            detached.name = "detached";
+            detached.fullName = "detached";
+            detached.isCurrent = true;
+            detached.sha = ret.second.trimmed();
+            detached.distanceToMaster = QString("Local");
+            detached.distanceToOrigin = QString("Local");
+
+            info.localBranches.append(detached);
          }
+      }
 
-         QLog_Info("UI", QString("... branches processed"));
+      for (const auto &branch : branches)
+      {
+         if (branch.isRemote)
+            info.remoteBranches.append(QString("remotes/%1").arg(branch.name));
+         else
+            info.localBranches.append(toLocalBranch(branch));
       }
 
-      processTags();
-      processStashes();
-      processSubmodules();
+      const GitTags tags(git);
+      info.tags = tags.getTags();
+      info.localTags = tags.getLocalTags();
+      info.stashes = GitStashes(git).getStashes();
+      info.submodules = GitSubmodules(git).getSubmodules();
+   }
 
-      QApplication::restoreOverrideCursor();
+   return info;
+}
+
+BranchesWidget::LocalBranch BranchesWidget::toLocalBranch(const BranchInfo &branch)
+{
+   LocalBranch localBranch;
+   localBranch.name = branch.name;
+   localBranch.fullName = branch.name;
+   localBranch.isCurrent = branch.isCurrent;
+   localBranch.sha = branch.sha;
+   localBranch.distanceToMaster = QString("Local");
+   localBranch.distanceToOrigin = QString("Local");
+
+   if (branch.aheadOfBase != -1)
+      localBranch.distanceToMaster = QString("%1\u2193 - %2\u2191").arg(branch.behindBase).arg(branch.aheadOfBase);
+
+   if (branch.hasUpstream && !branch.isUpstreamGone)
+      localBranch.distanceToOrigin = QString("%1\u2191").arg(branch.aheadOfUpstream + branch.behindUpstream);
+
+   return localBranch;
+}
+
+void BranchesWidget::onBranchesInfoLoaded(const BranchesInfo &info)
+{
+   clear();
+
+   if (info.success)
+   {
+      QLog_Info("UI", QString("Processing branches..."));
+
+      mRemoteBranchesTree->addTopLevelItem(new QTreeWidgetItem({ "origin" }));
+
+      for (const auto &localBranch : info.localBranches)
+         processLocalBranch(localBranch);
+
+      for (const auto &remoteBranch : info.remoteBranches)
+         processRemoteBranch(remoteBranch);
+
+      QLog_Info("UI", QString("... branches processed"));
+
+      processTags(info.tags, info.localTags);
+      processStashes(info.stashes);
+      processSubmodules(info.submodules);
 
       adjustBranchesTree(mLocalBranchesTree);
    }
@@ -262,38 +339,13 @@ void BranchesWidget::clear()
    blockSignals(false);
 }
 
-void BranchesWidget::processLocalBranch(QString branch)
+void BranchesWidget::processLocalBranch(const LocalBranch &localBranch)
 {
-   QLog_Debug("UI", QString("Adding local branch {%1}").arg(branch));
-
-   auto fullBranchName = branch;
-   auto isCurrentBranch = false;
-   QString sha;
-
-   if (branch.startsWith('*'))
-   {
-      branch.replace('*', "");
-      fullBranchName.replace('*', "");
-      isCurrentBranch = true;
-
-      if (fullBranchName.startsWith("(HEADdetachedat"))
-      {
-         auto shortSha = fullBranchName.remove("(HEADdetachedat");
-         sha = shortSha.remove(")");
-
-         fullBranchName = "detached";
-         branch = "detached";
-      }
-   }
-   else
-   {
-      QScopedPointer<GitBranches> git(new GitBranches(mGit));
-      sha = git->getLastCommitOfBranch(fullBranchName).output.toString();
-   }
+   QLog_Debug("UI", QString("Adding local branch {%1}").arg(localBranch.name));
 
    QTreeWidgetItem *parent = nullptr;
-   auto folders = branch.split("/");
-   branch = folders.takeLast();
+   auto folders = localBranch.name.split("/");
+   const auto branch = folders.takeLast();
 
    for (const auto &folder : qAsConst(folders))
    {
@@ -325,37 +377,13 @@ void BranchesWidget::processLocalBranch(QString branch)
    auto item = new QTreeWidgetItem(parent);
    item->setChildIndicatorPolicy(QTreeWidgetItem::DontShowIndicator);
    item->setText(0, branch);
-   item->setData(0, Qt::UserRole, isCurrentBranch);
-   item->setData(0, Qt::UserRole + 1, fullBranchName);
+   item->setData(0, Qt::UserRole, localBranch.isCurrent);
+   item->setData(0, Qt::UserRole + 1, localBranch.fullName);
    item->setData(0, Qt::UserRole + 2, true);
-   item->setData(0, Qt::UserRole + 3, sha);
-   item->setData(0, Qt::ToolTipRole, fullBranchName);
-
-   QLog_Debug("UI", QString("Calculating distances..."));
-
-   QScopedPointer<GitBranches> git(new GitBranches(mGit));
-
-   auto distanceToMaster = QString("Local");
-   auto distanceToOrigin = QString("Local");
-
-   if (fullBranchName != "detached")
-   {
-      distanceToMaster = git->getDistanceBetweenBranches(true, fullBranchName).output.toString();
-      distanceToMaster.replace('\n', "");
-      distanceToMaster.replace('\t', "\u2193 - ");
-      distanceToMaster.append("\u2191");
-
-      distanceToOrigin = git->getDistanceBetweenBranches(false, fullBranchName).output.toString();
-
-      if (!distanceToOrigin.contains("fatal"))
-      {
-         distanceToOrigin.replace('\n', "");
-         distanceToOrigin.append("\u2191");
-      }
-   }
-
-   item->setText(1, distanceToMaster);
-   item->setText(2, distanceToOrigin);
+   item->setData(0, Qt::UserRole + 3, localBranch.sha);
+   item->setData(0, Qt::ToolTipRole, localBranch.fullName);
+   item->setText(1, localBranch.distanceToMaster);
+   item->setText(2, localBranch.distanceToOrigin);
 
    mLocalBranchesTree->addTopLevelItem(item);
 
@@ -409,12 +437,8 @@ void BranchesWidget::processRemoteBranch(QString branch)
    item->setData(0, Qt::ToolTipRole, fullBranchName);
 }
 
-void BranchesWidget::processTags()
+void BranchesWidget::processTags(const QVector<QString> &tags, const QVector<QString> &localTags)
 {
-   QScopedPointer<GitTags> git(new GitTags(mGit));
-   const auto tags = git->getTags();
-   const auto localTags = git->getLocalTags();
-
    QLog_Info("UI", QString("Fetching {%1} tags").arg(tags.count()));
 
    for (auto tag : tags)
@@ -436,11 +460,8 @@ void BranchesWidget::processTags()
    mTagsCount->setText(QString("(%1)").arg(tags.count()));
 }
 
-void BranchesWidget::processStashes()
+void BranchesWidget::processStashes(const QVector<QString> &stashes)
 {
-   QScopedPointer<GitStashes> git(new GitStashes(mGit));
-   const auto stashes = git->getStashes();
-
    QLog_Info("UI", QString("Fetching {%1} stashes").arg(stashes.count()));
 
    for (const auto &stash : stashes)
@@ -455,11 +476,8 @@ void BranchesWidget::processStashes()
    mStashesCount->setText(QString("(%1)").arg(stashes.count()));
 }
 
-void BranchesWidget::processSubmodules()
+void BranchesWidget::processSubmodules(const QVector<QString> &submodules)
 {
-   QScopedPointer<GitSubmodules> git(new GitSubmodules(mGit));
-   const auto submodules = git->getSubmodules();
-
    QLog_Info("UI", QString("Fetching {%1} submodules").arg(submodules.count()));
 
    for (const auto &submodule : submodules)
@@ -602,15 +620,12 @@ void BranchesWidget::onSubmodulesHeaderClicked()
 void BranchesWidget::onTagClicked(QListWidgetItem *item)
 {
    QScopedPointer<GitTags> git(new GitTags(mGit));
-   const auto sha = git->getTagCommit(item->text()).output.toString();
-
-   emit signalSelectCommit(sha);
+   git->requestTagCommit(item->text(), this, [this](const QString &sha) { emit signalSelectCommit(sha); });
 }
 
 void BranchesWidget::onStashClicked(QListWidgetItem *item)
 {
    QScopedPointer<GitTags> git(new GitTags(mGit));
-   const auto sha = git->getTagCommit(item->data(Qt::UserRole).toString()).output.toString();
-
-   emit signalSelectCommit(sha);
+   git->requestTagCommit(item->data(Qt::UserRole).toString(), this,
+                         [this](const QString &sha) { emit signalSelectCommit(sha); });
 }
@@ -24,12 +24,17 @@
  ***************************************************************************************/
 
 #include <QFrame>
+#include <QStringList>
+#include <QVector>
 
 class BranchTreeWidget;
 class QListWidget;
 class QListWidgetItem;
 class QLabel;
 class GitBase;
+class CommitStore;
+class RevisionsCache;
+struct BranchInfo;
 
 class BranchesWidget : public QFrame
 {
@@ -42,12 +47,37 @@ signals:
    void signalOpenSubmodule(const QString &submoduleName);
 
 public:
-   explicit BranchesWidget(const QSharedPointer<GitBase> &git, QWidget *parent = nullptr);
+   explicit BranchesWidget(const QSharedPointer<RevisionsCache> &cache, const QSharedPointer<GitBase> &git,
+                           QWidget *parent = nullptr);
    void showBranches();
    void clear();
 
 private:
+   struct LocalBranch
+   {
+      QString name;
+      QString fullName;
+      bool isCurrent = false;
+      QString sha;
+      QString distanceToMaster;
+      QString distanceToOrigin;
+   };
+
+   // Everything the panel shows. It is gathered in the background and shown at once.
+   struct BranchesInfo
+   {
+      bool success = false;
+      QVector<LocalBranch> localBranches;
+      QStringList remoteBranches;
+      QVector<QString> tags;
+      QVector<QString> localTags;
+      QVector<QString> stashes;
+      QVector<QString> submodules;
+   };
+
+   QSharedPointer<RevisionsCache> mCache;
    QSharedPointer<GitBase> mGit;
+   int mLoadRequest = 0;
    BranchTreeWidget *mLocalBranchesTree = nullptr;
    BranchTreeWidget *mRemoteBranchesTree = nullptr;
    QListWidget *mTagsList = nullptr;
@@ -60,11 +90,14 @@ private:
    QLabel *mSubmodulesCount = nullptr;
    QLabel *mSubmodulesArrow = nullptr;
 
-   void processLocalBranch(QString branch);
+   static BranchesInfo loadBranchesInfo(const QSharedPointer<GitBase> &git, const CommitStore &loadedCommits);
+   static LocalBranch toLocalBranch(const BranchInfo &branch);
+   void onBranchesInfoLoaded(const BranchesInfo &info);
+   void processLocalBranch(const LocalBranch &localBranch);
    void processRemoteBranch(QString branch);
-   void processTags();
-   void processStashes();
-   void processSubmodules();
+   void processTags(const QVector<QString> &tags, const QVector<QString> &localTags);
+   void processStashes(const QVector<QString> &stashes);
+   void processSubmodules(const QVector<QString> &submodules);
    void adjustBranchesTree(BranchTreeWidget *treeWidget);
    void showTagsContextMenu(const QPoint &p);
    void showStashesContextMenu(const QPoint &p);
@@ -2,6 +2,7 @@
 
 #include <RevisionsCache.h>
 #include <CommitInfo.h>
+#include <GitCommitBodies.h>
 #include <FileListWidget.h>
 
 #include <QLabel>
@@ -120,12 +121,22 @@ void CommitInfoWidget::configure(const QString &sha)
          labelAuthor->setText(authorName);
          labelDateTime->setText(commitDate.toString("dd/MM/yyyy hh:mm"));
 
-         const auto description = currentRev.longLog().trimmed();
-         labelDescription->setText(description.isEmpty() ? "No description provided." : description);
+         labelDescription->clear();
 
-         auto f = labelDescription->font();
-         f.setItalic(description.isEmpty());
-         labelDescription->setFont(f);
+         // The body is read in the background. The answer is dropped if another commit was selected meanwhile.
+         const auto currentSha = mCurrentSha;
+
+         GitCommitBodies(mGit, mCache).requestLongLog(currentSha, this, [this, currentSha](const QString &longLog) {
+            if (mCurrentSha != currentSha)
+               return;
+
+            const auto description = longLog.trimmed();
+            labelDescription->setText(description.isEmpty() ? "No description provided." : description);
+
+            auto f = labelDescription->font();
+            f.setItalic(description.isEmpty());
+            labelDescription->setFont(f);
+         });
 
          fileListWidget->insertFiles(mCurrentSha, mParentSha);
          labelModCount->setText(QString("(%1)").arg(fileListWidget->count()));
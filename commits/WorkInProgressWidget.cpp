@@ -2,8 +2,10 @@
 #include <ui_WorkInProgressWidget.h>
 
 #include <GitRepoLoader.h>
+#include <GitAsync.h>
 #include <GitBase.h>
 #include <GitLocal.h>
+#include <GitCommitBodies.h>
 #include <GitQlientStyles.h>
 #include <CommitInfo.h>
 #include <RevisionFiles.h>
@@ -32,6 +34,19 @@ using namespace QLogger;
 
 const int WorkInProgressWidget::kMaxTitleChars = 50;
 
+namespace
+{
+// Reads the files of the WIP commit again in the thread of the commit, so it sees the last state of the working
+// directory. The cache of the UI can't be touched from there, so a temporary one keeps them.
+RevisionFiles loadWipFiles(const QSharedPointer<GitBase> &git, const QString &parentSha)
+{
+   const auto cache = QSharedPointer<RevisionsCache>::create();
+   GitRepoLoader(git, cache).updateWipRevision();
+
+   return cache->getRevisionFile(CommitInfo::ZERO_SHA, parentSha);
+}
+}
+
 QString WorkInProgressWidget::lastMsgBeforeError;
 
 enum GitQlientRole
@@ -167,11 +182,9 @@ void WorkInProgressWidget::resetInfo(bool force)
    {
       QPair<QString, QString> logMessage;
 
+      // The body of the amended commit is set when it arrives
       if (mIsAmend)
-      {
-         const auto revInfo = mCache->getCommitInfo(mCurrentSha);
-         logMessage = qMakePair(revInfo.shortLog(), revInfo.longLog().trimmed());
-      }
+         logMessage.first = mCache->getCommitInfo(mCurrentSha).shortLog();
 
       msg = logMessage.second.trimmed();
 
@@ -187,6 +200,19 @@ void WorkInProgressWidget::resetInfo(bool force)
       ui->teDescription->moveCursor(QTextCursor::Start);
    }
 
+   if (mIsAmend && lastMsgBeforeError.isEmpty())
+   {
+      const auto sha = mCurrentSha;
+
+      GitCommitBodies(mGit, mCache).requestLongLog(sha, this, [this, sha](const QString &longLog) {
+         if (mIsAmend && mCurrentSha == sha)
+         {
+            ui->teDescription->setPlainText(longLog.trimmed());
+            ui->teDescription->moveCursor(QTextCursor::Start);
+         }
+      });
+   }
+
    ui->pbCommit->setEnabled(ui->stagedFilesList->count());
 }
 
@@ -594,11 +620,10 @@ bool WorkInProgressWidget::hasConflicts()
    return false;
 }
 
-bool WorkInProgressWidget::commitChanges()
+void WorkInProgressWidget::commitChanges()
 {
    QString msg;
    QStringList selFiles = getFiles();
-   auto done = false;
 
    if (!selFiles.isEmpty())
    {
@@ -607,34 +632,37 @@ bool WorkInProgressWidget::commitChanges()
                               tr("There are files with conflicts. Please, resolve the conflicts first."));
       else if (checkMsg(msg))
       {
-         const auto revInfo = mCache->getCommitInfo(CommitInfo::ZERO_SHA);
-         QScopedPointer<GitRepoLoader> gitLoader(new GitRepoLoader(mGit, mCache));
-         gitLoader->updateWipRevision();
-         const auto files = mCache->getRevisionFile(CommitInfo::ZERO_SHA, revInfo.parent(0));
-
-         QApplication::setOverrideCursor(QCursor(Qt::WaitCursor));
-         QScopedPointer<GitLocal> git(new GitLocal(mGit));
-         const auto ret = git->commitFiles(selFiles, files, msg, false);
-         QApplication::restoreOverrideCursor();
-
-         lastMsgBeforeError = (ret.success ? "" : msg);
-
-         emit signalChangesCommitted(ret.success);
-
-         done = true;
-
-         ui->leCommitTitle->clear();
-         ui->teDescription->clear();
+         const auto parentSha = mCache->getCommitInfo(CommitInfo::ZERO_SHA).parent(0);
+
+         // The commit runs in the background. The button is enabled again when the WIP is reloaded.
+         ui->pbCommit->setEnabled(false);
+
+         runGitAsync(
+             mGit, [selFiles, parentSha, msg](const QSharedPointer<GitBase> &git) mutable {
+                return GitLocal(git).commitFiles(selFiles, loadWipFiles(git, parentSha), msg, false);
+             },
+             this,
+             [this, msg](const GitExecResult &ret) {
+                lastMsgBeforeError = (ret.success ? "" : msg);
+
+                // The message is kept until the commit is done, so it can be fixed if it fails
+                if (ret.success)
+                {
+                   ui->leCommitTitle->clear();
+                   ui->teDescription->clear();
+                }
+                else
+                   ui->pbCommit->setEnabled(ui->stagedFilesList->count() > 0);
+
+                emit signalChangesCommitted(ret.success);
+             });
       }
    }
-
-   return done;
 }
 
-bool WorkInProgressWidget::amendChanges()
+void WorkInProgressWidget::amendChanges()
 {
    QStringList selFiles = getFiles();
-   auto done = false;
 
    if (!selFiles.isEmpty())
    {
@@ -647,23 +675,23 @@ bool WorkInProgressWidget::amendChanges()
       {
          const auto author = QString("%1<%2>").arg(ui->leAuthorName->text(), ui->leAuthorEmail->text());
 
-         const auto revInfo = mCache->getCommitInfo(CommitInfo::ZERO_SHA);
-         QScopedPointer<GitRepoLoader> gitLoader(new GitRepoLoader(mGit, mCache));
-         gitLoader->updateWipRevision();
-         const auto files = mCache->getRevisionFile(CommitInfo::ZERO_SHA, revInfo.parent(0));
+         const auto parentSha = mCache->getCommitInfo(CommitInfo::ZERO_SHA).parent(0);
 
-         QApplication::setOverrideCursor(QCursor(Qt::WaitCursor));
-         QScopedPointer<GitLocal> git(new GitLocal(mGit));
-         const auto ret = git->commitFiles(selFiles, files, msg, true, author);
-         QApplication::restoreOverrideCursor();
+         ui->pbCommit->setEnabled(false);
 
-         emit signalChangesCommitted(ret.success);
+         runGitAsync(
+             mGit, [selFiles, parentSha, msg, author](const QSharedPointer<GitBase> &git) mutable {
+                return GitLocal(git).commitFiles(selFiles, loadWipFiles(git, parentSha), msg, true, author);
+             },
+             this,
+             [this](const GitExecResult &ret) {
+                if (!ret.success)
+                   ui->pbCommit->setEnabled(ui->stagedFilesList->count() > 0);
 
-         done = true;
+                emit signalChangesCommitted(ret.success);
+             });
       }
    }
-
-   return done;
 }
 
 void WorkInProgressWidget::clear()
@@ -75,8 +75,9 @@ private:
    void addFileToCommitList(QListWidgetItem *item);
    void revertAllChanges();
    void removeFileFromCommitList(QListWidgetItem *item);
-   bool commitChanges();
-   bool amendChanges();
+   // The commit runs in the background and its result arrives with signalChangesCommitted
+   void commitChanges();
+   void amendChanges();
    void showUnstagedMenu(const QPoint &pos);
    void showUntrackedMenu(const QPoint &pos);
    void showStagedMenu(const QPoint &pos);
@@ -16,6 +16,7 @@ using namespace QLogger;
 GeneralConfigPage::GeneralConfigPage(QWidget *parent)
    : QFrame(parent)
    , mAutoFetch(new QSpinBox())
+   , mPageSize(new QSpinBox())
    , mAutoPrune(new QCheckBox())
    , mDisableLogs(new QCheckBox())
    , mLevelCombo(new QComboBox())
@@ -50,6 +51,29 @@ GeneralConfigPage::GeneralConfigPage(QWidget *parent)
    fetchLayoutLabel->addWidget(new QLabel(tr("Auto-Fetch interval")));
    fetchLayoutLabel->addStretch();
 
+   mPageSize->setRange(0, 1000000);
+   mPageSize->setSingleStep(1000);
+   mPageSize->setValue(settings.value("historyPageSize", 0).toInt());
+
+   const auto labelPageSize = new QLabel(tr("Number of commits loaded at once. The next ones are loaded when scrolling "
+                                            "to the end of the history. Choose 0 to load the whole history. "
+                                            "It applies to the repositories opened after the change."));
+   labelPageSize->setWordWrap(true);
+
+   const auto pageSizeLayout = new QVBoxLayout();
+   pageSizeLayout->setAlignment(Qt::AlignTop);
+   pageSizeLayout->setContentsMargins(QMargins());
+   pageSizeLayout->setSpacing(0);
+   pageSizeLayout->addWidget(mPageSize);
+   pageSizeLayout->addWidget(labelPageSize);
+
+   const auto pageSizeLayoutLabel = new QVBoxLayout();
+   pageSizeLayoutLabel->setAlignment(Qt::AlignTop);
+   pageSizeLayoutLabel->setContentsMargins(QMargins());
+   pageSizeLayoutLabel->setSpacing(0);
+   pageSizeLayoutLabel->addWidget(new QLabel(tr("History page size")));
+   pageSizeLayoutLabel->addStretch();
+
    mAutoPrune->setChecked(settings.value("autoPrune", true).toBool());
 
    mDisableLogs->setChecked(settings.value("logsDisabled", false).toBool());
@@ -78,6 +102,8 @@ GeneralConfigPage::GeneralConfigPage(QWidget *parent)
    layout->setAlignment(Qt::AlignTop);
    layout->addLayout(fetchLayoutLabel, 0, 0);
    layout->addLayout(fetchLayout, 0, 1);
+   layout->addLayout(pageSizeLayoutLabel, 1, 0);
+   layout->addLayout(pageSizeLayout, 1, 1);
    layout->addWidget(new QLabel(tr("Auto-Prune")), 2, 0);
    layout->addWidget(mAutoPrune, 2, 1);
    layout->addWidget(new QLabel(tr("Disable logs")), 3, 0);
@@ -94,6 +120,7 @@ void GeneralConfigPage::resetChanges()
 {
    GitQlientSettings settings;
    mAutoFetch->setValue(settings.value("autoFetch", 0).toInt());
+   mPageSize->setValue(settings.value("historyPageSize", 0).toInt());
    mAutoPrune->setChecked(settings.value("autoPrune", true).toBool());
    mDisableLogs->setChecked(settings.value("logsDisabled", false).toBool());
    mLevelCombo->setCurrentIndex(settings.value("logsLevel", 2).toInt());
@@ -107,6 +134,7 @@ void GeneralConfigPage::applyChanges()
 {
    GitQlientSettings settings;
    settings.setValue("autoFetch", mAutoFetch->value());
+   settings.setValue("historyPageSize", mPageSize->value());
    settings.setValue("autoPrune", mAutoPrune->isChecked());
    settings.setValue("logsDisabled", mDisableLogs->isChecked());
    settings.setValue("logsLevel", mLevelCombo->currentIndex());
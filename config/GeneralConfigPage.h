@@ -40,6 +40,7 @@ public:
 
 private:
    QSpinBox *mAutoFetch = nullptr;
+   QSpinBox *mPageSize = nullptr;
    QCheckBox *mAutoPrune = nullptr;
    QCheckBox *mDisableLogs = nullptr;
    QComboBox *mLevelCombo = nullptr;
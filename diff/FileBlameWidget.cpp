@@ -2,6 +2,8 @@
 
 #include <RevisionsCache.h>
 #include <FileDiffView.h>
+#include <GitAsync.h>
+#include <GitBase.h>
 #include <GitHistory.h>
 #include <CommitInfo.h>
 #include <ClickableFrame.h>
@@ -79,24 +81,33 @@ FileBlameWidget::FileBlameWidget(const QSharedPointer<RevisionsCache> &cache, co
 void FileBlameWidget::setup(const QString &fileName, const QString &currentSha, const QString &previousSha)
 {
    mCurrentFile = fileName;
-   QScopedPointer<GitHistory> git(new GitHistory(mGit));
-   const auto ret = git->blame(mCurrentFile, currentSha);
-
-   if (ret.success && !ret.output.toString().startsWith("fatal:"))
-   {
-      delete mAnotation;
-      mAnotation = nullptr;
-
-      mCurrentSha->setText(currentSha);
-      mPreviousSha->setText(previousSha);
-
-      const auto annotations = processBlame(ret.output.toString());
-      formatAnnotatedFile(annotations);
-   }
-   else
-      QMessageBox::warning(
-          this, tr("File not in Git"),
-          tr("The file {%1} is not under Git control version. You cannot blame it.").arg(mCurrentFile));
+   mRequestedSha = currentSha;
+
+   runGitAsync(
+       mGit, [fileName, currentSha](const QSharedPointer<GitBase> &git) {
+          return GitHistory(git).blame(fileName, currentSha);
+       },
+       this, [this, fileName, currentSha, previousSha](const GitExecResult &ret) {
+          // Another blame could have been requested while this one was loading
+          if (fileName != mCurrentFile || currentSha != mRequestedSha)
+             return;
+
+          if (ret.success && !ret.output.toString().startsWith("fatal:"))
+          {
+             delete mAnotation;
+             mAnotation = nullptr;
+
+             mCurrentSha->setText(currentSha);
+             mPreviousSha->setText(previousSha);
+
+             const auto annotations = processBlame(ret.output.toString());
+             formatAnnotatedFile(annotations);
+          }
+          else
+             QMessageBox::warning(
+                 this, tr("File not in Git"),
+                 tr("The file {%1} is not under Git control version. You cannot blame it.").arg(mCurrentFile));
+       });
 }
 
 void FileBlameWidget::reload(const QString &currentSha, const QString &previousSha)
@@ -58,6 +58,7 @@ private:
    QFont mInfoFont;
    QFont mCodeFont;
    QString mCurrentFile;
+   QString mRequestedSha;
 
    struct Annotation
    {
@@ -1,6 +1,8 @@
 #include "FullDiffWidget.h"
 
 #include <CommitInfo.h>
+#include <GitAsync.h>
+#include <GitBase.h>
 #include <GitHistory.h>
 #include <GitQlientStyles.h>
 
@@ -107,9 +109,12 @@ void FullDiffWidget::loadDiff(const QString &sha, const QString &diffToSha)
    mCurrentSha = sha;
    mPreviousSha = diffToSha;
 
-   QScopedPointer<GitHistory> git(new GitHistory(mGit));
-   const auto ret = git->getCommitDiff(mCurrentSha, mPreviousSha);
-
-   if (ret.success)
-      processData(ret.output.toString());
+   runGitAsync(
+       mGit,
+       [sha, diffToSha](const QSharedPointer<GitBase> &git) { return GitHistory(git).getCommitDiff(sha, diffToSha); },
+       this, [this, sha, diffToSha](const GitExecResult &ret) {
+          // Another diff could have been requested while this one was loading
+          if (ret.success && sha == mCurrentSha && diffToSha == mPreviousSha)
+             processData(ret.output.toString());
+       });
 }
@@ -141,6 +141,11 @@ bool AGitProcess::execute(const QString &command)
 
       if (!processStarted)
          QLog_Warning("Git", QString("Unable to start the process:\n%1\nMore info:\n%2").arg(mCommand, errorString()));
+      else if (!mStandardInput.isEmpty())
+      {
+         write(mStandardInput);
+         closeWriteChannel();
+      }
    }
 
    return processStarted;
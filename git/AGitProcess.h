@@ -36,6 +36,7 @@ public:
    explicit AGitProcess(const QString &workingDir);
 
    virtual bool run(const QString &command, QString &output) = 0;
+   void setStandardInput(const QByteArray &input) { mStandardInput = input; }
    void onCancel();
 
 protected:
@@ -43,6 +44,7 @@ protected:
    QString mWorkingDirectory;
    QString mErrorOutput;
    QString mCommand;
+   QByteArray mStandardInput;
    bool mRealError = false;
    bool mCanceling = false;
    bool execute(const QString &command);
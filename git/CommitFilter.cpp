@@ -0,0 +1,70 @@
+#include "CommitFilter.h"
+
+#include <QDateTime>
+
+bool CommitFilter::operator==(const CommitFilter &filter) const
+{
+   return author == filter.author && committer == filter.committer && message == filter.message && from == filter.from
+       && to == filter.to;
+}
+
+bool CommitFilter::isEmpty() const
+{
+   return author.isEmpty() && committer.isEmpty() && message.pattern().isEmpty() && !from.isValid() && !to.isValid();
+}
+
+bool CommitFilter::matches(const CommitStore &commits, int row) const
+{
+   // The WIP has no commit behind it
+   if (commits.rowId(row) == -1)
+      return false;
+
+   const auto date = commits.date(row);
+
+   if (from.isValid() && date < QDateTime(from, QTime(0, 0)).toSecsSinceEpoch())
+      return false;
+
+   if (to.isValid() && date >= QDateTime(to.addDays(1), QTime(0, 0)).toSecsSinceEpoch())
+      return false;
+
+   if (!author.isEmpty() && !commits.fieldStr(row, CommitInfo::Field::AUTHOR).contains(author, Qt::CaseInsensitive))
+      return false;
+
+   if (!committer.isEmpty()
+       && !commits.fieldStr(row, CommitInfo::Field::COMMITER).contains(committer, Qt::CaseInsensitive))
+      return false;
+
+   if (!message.pattern().isEmpty() && !message.match(commits.fieldStr(row, CommitInfo::Field::SHORT_LOG)).hasMatch())
+      return false;
+
+   return true;
+}
+
+CommitFilterChunk::CommitFilterChunk(const CommitStore &commits, const CommitFilter &filter)
+   : mCommits(commits)
+   , mFilter(filter)
+{
+}
+
+QVector<int> CommitFilterChunk::operator()(const QPair<int, int> &range) const
+{
+   QVector<int> rows;
+
+   for (auto row = range.first; row < range.second; ++row)
+   {
+      if (mFilter.matches(mCommits, row))
+         rows.append(row);
+   }
+
+   return rows;
+}
+
+QVector<QPair<int, int>> CommitFilterChunk::ranges(int firstRow, int count, int size)
+{
+   QVector<QPair<int, int>> ranges;
+
+   for (auto first = firstRow; first < count; first += size)
+      ranges.append({ first, qMin(first + size, count) });
+
+   return ranges;
+}
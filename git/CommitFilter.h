@@ -0,0 +1,69 @@
+#pragma once
+
+/****************************************************************************************
+ ** GitQlient is an application to manage and operate one or several Git repositories. With
+ ** GitQlient you will be able to add commits, branches and manage all the options Git provides.
+ ** Copyright (C) 2019  Francesc Martinez
+ **
+ ** LinkedIn: www.linkedin.com/in/cescmm/
+ ** Web: www.francescmm.com
+ **
+ ** This program is free software; you can redistribute it and/or
+ ** modify it under the terms of the GNU Lesser General Public
+ ** License as published by the Free Software Foundation; either
+ ** version 2 of the License, or (at your option) any later version.
+ **
+ ** This program is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ ** Lesser General Public License for more details.
+ **
+ ** You should have received a copy of the GNU Lesser General Public
+ ** License along with this library; if not, write to the Free Software
+ ** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ***************************************************************************************/
+
+#include <CommitStore.h>
+
+#include <QDate>
+#include <QRegularExpression>
+#include <QString>
+#include <QVector>
+
+// Criteria to filter the history. The empty fields don't filter: a commit passes when it matches all the others.
+struct CommitFilter
+{
+   // Text contained in the author or the committer (name or email), case insensitive
+   QString author;
+   QString committer;
+   // Pattern to match against the summary of the commit
+   QRegularExpression message;
+   // Days of the commit date, both included
+   QDate from;
+   QDate to;
+
+   bool operator==(const CommitFilter &filter) const;
+   bool isEmpty() const;
+   bool matches(const CommitStore &commits, int row) const;
+};
+
+// Filters a range of rows of the store. It's meant to be used with QtConcurrent::mapped, so the matches of each chunk
+// of the history can be shown as soon as the chunk is done.
+class CommitFilterChunk
+{
+public:
+   using result_type = QVector<int>;
+
+   // The store is implicitly shared, so the functor keeps a copy and can outlive the one of the UI thread
+   CommitFilterChunk(const CommitStore &commits, const CommitFilter &filter);
+
+   // The range goes from the first row to the last one, not included
+   QVector<int> operator()(const QPair<int, int> &range) const;
+
+   // Splits the rows from the first one up to the count in ranges of the given size
+   static QVector<QPair<int, int>> ranges(int firstRow, int count, int size);
+
+private:
+   CommitStore mCommits;
+   CommitFilter mFilter;
+};
@@ -0,0 +1,401 @@
+#include "CommitGraph.h"
+
+#include <GraphWalk.h>
+
+#include <QDir>
+#include <QFile>
+#include <QtEndian>
+
+#include <QLogger.h>
+
+#include <queue>
+#include <tuple>
+
+using namespace QLogger;
+
+namespace
+{
+const int HEADER_SIZE = 8;
+const int CHUNK_LOOKUP_ENTRY_SIZE = 12;
+const int FANOUT_ENTRIES = 256;
+const quint8 GRAPH_VERSION = 1;
+const quint8 HASH_VERSION_SHA1 = 1;
+const quint8 HASH_VERSION_SHA256 = 2;
+
+const quint32 CHUNK_OID_FANOUT = 0x4f494446; // "OIDF"
+const quint32 CHUNK_OID_LOOKUP = 0x4f49444c; // "OIDL"
+const quint32 CHUNK_COMMIT_DATA = 0x43444154; // "CDAT"
+const quint32 CHUNK_EXTRA_EDGES = 0x45444745; // "EDGE"
+
+// Each commit of the CDAT chunk has the tree id followed by two parents and the generation and date
+const int COMMIT_DATA_EXTRA_SIZE = 16;
+const quint32 PARENT_NONE = 0x70000000;
+const quint32 EXTRA_EDGES_NEEDED = 0x80000000;
+const quint32 LAST_EDGE = 0x80000000;
+const quint32 EDGE_MASK = 0x7fffffff;
+
+quint32 readUInt32(const uchar *data)
+{
+   return qFromBigEndian<quint32>(data);
+}
+
+quint64 readUInt64(const uchar *data)
+{
+   return qFromBigEndian<quint64>(data);
+}
+
+// The parents have a lower generation than their children. Without generation numbers the order is not known, so
+// those commits can't be walked.
+struct CommitGraphWalk
+{
+   const CommitGraph &graph;
+
+   std::pair<quint32, qint64> key(int pos) const
+   {
+      return std::make_pair(graph.generation(pos), graph.commitDate(pos));
+   }
+
+   bool parents(int pos, QVector<int> &parents) const
+   {
+      auto allGenerations = true;
+
+      for (const auto parent : graph.parents(pos))
+      {
+         if (graph.generation(parent) != 0)
+            parents.append(parent);
+         else
+            allGenerations = false;
+      }
+
+      return allGenerations;
+   }
+};
+}
+
+bool CommitGraph::open(const QString &objectsInfoDir)
+{
+   close();
+
+   const QDir dir(objectsInfoDir);
+   const auto singleFile = dir.filePath("commit-graph");
+   auto ok = false;
+
+   if (QFile::exists(singleFile))
+      ok = openLayer(singleFile);
+   else
+   {
+      // The chain lists the files of the split commit-graph, starting by the base one
+      QFile chain(dir.filePath("commit-graphs/commit-graph-chain"));
+
+      if (chain.open(QIODevice::ReadOnly))
+      {
+         const auto hashes = QString::fromLatin1(chain.readAll()).split('\n', QString::SkipEmptyParts);
+
+         ok = !hashes.isEmpty();
+
+         for (const auto &hash : hashes)
+            ok = ok && openLayer(dir.filePath(QString("commit-graphs/graph-%1.graph").arg(hash.trimmed())));
+      }
+   }
+
+   if (!ok)
+      close();
+
+   return ok;
+}
+
+void CommitGraph::close()
+{
+   mLayers.clear();
+   mFiles.clear();
+   mHashSize = 0;
+}
+
+bool CommitGraph::openLayer(const QString &path)
+{
+   const auto file = QSharedPointer<QFile>::create(path);
+
+   if (!file->open(QIODevice::ReadOnly))
+      return false;
+
+   const auto size = file->size();
+   const auto data = size >= HEADER_SIZE ? file->map(0, size) : nullptr;
+
+   if (!data)
+   {
+      QLog_Warning("Git", QString("Unable to map the commit-graph {%1}.").arg(path));
+      return false;
+   }
+
+   auto hashSize = 0;
+
+   if (data[5] == HASH_VERSION_SHA1)
+      hashSize = ObjectId::SHA1_SIZE;
+   else if (data[5] == HASH_VERSION_SHA256)
+      hashSize = ObjectId::SHA256_SIZE;
+
+   const auto chunksCount = static_cast<int>(data[6]);
+
+   // Each file of a chain is based on all the previous ones
+   auto ok = memcmp(data, "CGPH", 4) == 0 && data[4] == GRAPH_VERSION && hashSize != 0
+       && (mHashSize == 0 || mHashSize == hashSize) && data[7] == mLayers.count()
+       && HEADER_SIZE + (chunksCount + 1) * CHUNK_LOOKUP_ENTRY_SIZE <= size;
+
+   Layer layer;
+   qint64 idsSize = -1;
+   qint64 commitDataSize = -1;
+
+   for (auto i = 0; ok && i < chunksCount; ++i)
+   {
+      const auto entry = data + HEADER_SIZE + i * CHUNK_LOOKUP_ENTRY_SIZE;
+      const auto chunkId = readUInt32(entry);
+      const auto offset = readUInt64(entry + 4);
+      const auto end = readUInt64(entry + CHUNK_LOOKUP_ENTRY_SIZE + 4);
+
+      ok = offset <= end && end <= static_cast<quint64>(size);
+
+      if (!ok)
+         break;
+
+      const auto chunk = data + offset;
+      const auto chunkSize = static_cast<qint64>(end - offset);
+
+      switch (chunkId)
+      {
+         case CHUNK_OID_FANOUT:
+            layer.fanout = chunk;
+            ok = chunkSize == FANOUT_ENTRIES * 4;
+            break;
+         case CHUNK_OID_LOOKUP:
+            layer.ids = chunk;
+            idsSize = chunkSize;
+            break;
+         case CHUNK_COMMIT_DATA:
+            layer.commitData = chunk;
+            commitDataSize = chunkSize;
+            break;
+         case CHUNK_EXTRA_EDGES:
+            layer.extraEdges = chunk;
+            layer.extraEdgesCount = static_cast<int>(chunkSize / 4);
+            break;
+         default:
+            break;
+      }
+   }
+
+   ok = ok && layer.fanout && layer.ids && layer.commitData;
+
+   if (ok)
+   {
+      // The fanout has the number of commits whose first byte is lower or equal than each value
+      for (auto i = 1; ok && i < FANOUT_ENTRIES; ++i)
+         ok = readUInt32(layer.fanout + 4 * (i - 1)) <= readUInt32(layer.fanout + 4 * i);
+
+      const auto count = static_cast<qint64>(readUInt32(layer.fanout + 4 * (FANOUT_ENTRIES - 1)));
+
+      layer.firstPos = this->count();
+      layer.count = static_cast<int>(count);
+
+      ok = ok && layer.firstPos + count <= EDGE_MASK && idsSize == count * hashSize
+          && commitDataSize == count * (hashSize + COMMIT_DATA_EXTRA_SIZE);
+   }
+
+   if (!ok)
+   {
+      QLog_Warning("Git", QString("The commit-graph {%1} is not valid.").arg(path));
+      return false;
+   }
+
+   mHashSize = hashSize;
+   mFiles.append(file);
+   mLayers.append(layer);
+
+   return true;
+}
+
+int CommitGraph::count() const
+{
+   return mLayers.isEmpty() ? 0 : mLayers.last().firstPos + mLayers.last().count;
+}
+
+int CommitGraph::find(const ObjectId &id) const
+{
+   if (id.size() != mHashSize)
+      return -1;
+
+   const auto firstByte = id.data()[0];
+
+   for (const auto &layer : mLayers)
+   {
+      auto low = firstByte == 0 ? 0 : static_cast<int>(readUInt32(layer.fanout + 4 * (firstByte - 1)));
+      auto high = static_cast<int>(readUInt32(layer.fanout + 4 * firstByte));
+
+      while (low < high)
+      {
+         const auto middle = low + (high - low) / 2;
+         const auto cmp
+             = memcmp(layer.ids + static_cast<qint64>(middle) * mHashSize, id.data(), static_cast<size_t>(mHashSize));
+
+         if (cmp == 0)
+            return layer.firstPos + middle;
+
+         if (cmp < 0)
+            low = middle + 1;
+         else
+            high = middle;
+      }
+   }
+
+   return -1;
+}
+
+ObjectId CommitGraph::id(int pos) const
+{
+   const auto &layer = this->layer(pos);
+
+   return ObjectId::fromBytes(layer.ids + static_cast<qint64>(pos - layer.firstPos) * mHashSize, mHashSize);
+}
+
+QVector<int> CommitGraph::parents(int pos) const
+{
+   const auto data = commitData(pos) + mHashSize;
+   const auto total = static_cast<quint32>(count());
+   const auto first = readUInt32(data);
+   const auto second = readUInt32(data + 4);
+   QVector<int> parents;
+
+   if (first != PARENT_NONE && first < total)
+      parents.append(static_cast<int>(first));
+
+   if (second == PARENT_NONE)
+      return parents;
+
+   if (!(second & EXTRA_EDGES_NEEDED))
+   {
+      if (second < total)
+         parents.append(static_cast<int>(second));
+
+      return parents;
+   }
+
+   // Octopus merges keep the second and next parents in the list of extra edges, the last one is flagged
+   const auto &layer = this->layer(pos);
+
+   for (auto edge = static_cast<int>(second & EDGE_MASK); edge < layer.extraEdgesCount; ++edge)
+   {
+      const auto value = readUInt32(layer.extraEdges + 4 * edge);
+
+      if ((value & EDGE_MASK) < total)
+         parents.append(static_cast<int>(value & EDGE_MASK));
+
+      if (value & LAST_EDGE)
+         break;
+   }
+
+   return parents;
+}
+
+quint32 CommitGraph::generation(int pos) const
+{
+   return readUInt32(commitData(pos) + mHashSize + 8) >> 2;
+}
+
+qint64 CommitGraph::commitDate(int pos) const
+{
+   // The date has 34 bits: the two lowest bits of the generation word are the highest ones of the date
+   const auto data = commitData(pos) + mHashSize + 8;
+
+   return (static_cast<qint64>(readUInt32(data) & 0x3) << 32) | readUInt32(data + 4);
+}
+
+QVector<int> CommitGraph::dateOrder(const QVector<int> &tips) const
+{
+   const auto total = count();
+   QVector<int> childrenCount(total, 0);
+   QVector<bool> visited(total, false);
+   QVector<int> pending;
+
+   for (const auto tip : tips)
+   {
+      if (tip >= 0 && tip < total && !visited.at(tip))
+      {
+         visited[tip] = true;
+         pending.append(tip);
+      }
+   }
+
+   while (!pending.isEmpty())
+   {
+      const auto pos = pending.takeLast();
+
+      for (const auto parent : parents(pos))
+      {
+         ++childrenCount[parent];
+
+         if (!visited.at(parent))
+         {
+            visited[parent] = true;
+            pending.append(parent);
+         }
+      }
+   }
+
+   // A commit can go next once all its children are in the order. The ties are solved by date and then by the order
+   // they became ready, the same way git does it.
+   std::priority_queue<std::tuple<qint64, qint64, int>> ready;
+   qint64 sequence = 0;
+   QVector<int> order;
+
+   for (const auto tip : tips)
+   {
+      if (tip >= 0 && tip < total && childrenCount.at(tip) == 0)
+      {
+         childrenCount[tip] = -1;
+         ready.emplace(commitDate(tip), -sequence++, tip);
+      }
+   }
+
+   while (!ready.empty())
+   {
+      const auto pos = std::get<2>(ready.top());
+      ready.pop();
+
+      order.append(pos);
+
+      for (const auto parent : parents(pos))
+      {
+         if (--childrenCount[parent] == 0)
+            ready.emplace(commitDate(parent), -sequence++, parent);
+      }
+   }
+
+   return order;
+}
+
+QPair<int, int> CommitGraph::aheadBehind(int left, int right) const
+{
+   const auto total = count();
+
+   // The generation 0 is the one of the files written before git had generation numbers
+   if (left < 0 || left >= total || right < 0 || right >= total || generation(left) == 0 || generation(right) == 0)
+      return qMakePair(-1, -1);
+
+   return GraphWalk::aheadBehind(CommitGraphWalk { *this }, left, right);
+}
+
+const CommitGraph::Layer &CommitGraph::layer(int pos) const
+{
+   auto i = mLayers.count() - 1;
+
+   while (i > 0 && pos < mLayers.at(i).firstPos)
+      --i;
+
+   return mLayers.at(i);
+}
+
+const uchar *CommitGraph::commitData(int pos) const
+{
+   const auto &layer = this->layer(pos);
+
+   return layer.commitData + static_cast<qint64>(pos - layer.firstPos) * (mHashSize + COMMIT_DATA_EXTRA_SIZE);
+}
@@ -0,0 +1,87 @@
+#pragma once
+
+/****************************************************************************************
+ ** GitQlient is an application to manage and operate one or several Git repositories. With
+ ** GitQlient you will be able to add commits, branches and manage all the options Git provides.
+ ** Copyright (C) 2019  Francesc Martinez
+ **
+ ** LinkedIn: www.linkedin.com/in/cescmm/
+ ** Web: www.francescmm.com
+ **
+ ** This program is free software; you can redistribute it and/or
+ ** modify it under the terms of the GNU Lesser General Public
+ ** License as published by the Free Software Foundation; either
+ ** version 2 of the License, or (at your option) any later version.
+ **
+ ** This program is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ ** Lesser General Public License for more details.
+ **
+ ** You should have received a copy of the GNU Lesser General Public
+ ** License along with this library; if not, write to the Free Software
+ ** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ***************************************************************************************/
+
+#include <ObjectId.h>
+
+#include <QPair>
+#include <QSharedPointer>
+#include <QString>
+#include <QVector>
+
+class QFile;
+
+// Reader of the commit-graph files that git writes in objects/info (git commit-graph write, gc, fetch, etc.). The file
+// is memory-mapped and gives the topology of the history (SHAs, parents, generation numbers and commit dates) without
+// parsing any commit object. Both the single file and the chain of split files are supported.
+//
+// The commits are identified by their position in the graph. In a chain, the positions of each file go after the ones
+// of the files it is based on.
+class CommitGraph
+{
+public:
+   CommitGraph() = default;
+
+   // Opens the commit-graph of the objects/info directory of a repository. It returns false if there isn't any or if it
+   // is not valid.
+   bool open(const QString &objectsInfoDir);
+   void close();
+   bool isOpen() const { return !mLayers.isEmpty(); }
+
+   int count() const;
+   int find(const ObjectId &id) const;
+   ObjectId id(int pos) const;
+   QVector<int> parents(int pos) const;
+   quint32 generation(int pos) const;
+   qint64 commitDate(int pos) const;
+
+   // Returns the commits reachable from the tips in the order of git log --date-order: no commit is shown before its
+   // children and, among the ones that can go next, the newest goes first.
+   QVector<int> dateOrder(const QVector<int> &tips) const;
+
+   // Returns the number of commits reachable from left but not from right, and the other way around, as git rev-list
+   // --left-right --count right...left. It walks only down to the merge bases. It returns -1 for both when the graph
+   // has no generation numbers for the commits.
+   QPair<int, int> aheadBehind(int left, int right) const;
+
+private:
+   struct Layer
+   {
+      const uchar *fanout = nullptr;
+      const uchar *ids = nullptr;
+      const uchar *commitData = nullptr;
+      const uchar *extraEdges = nullptr;
+      int extraEdgesCount = 0;
+      int firstPos = 0;
+      int count = 0;
+   };
+
+   QVector<QSharedPointer<QFile>> mFiles;
+   QVector<Layer> mLayers;
+   int mHashSize = 0;
+
+   bool openLayer(const QString &path);
+   const Layer &layer(int pos) const;
+   const uchar *commitData(int pos) const;
+};
@@ -2,13 +2,25 @@
 
 #include <QStringList>
 
+#include <cstring>
+
+namespace
+{
+// log size, SHAs, committer, author, date and short log
+const int HEADER_LINES = 6;
+}
+
 const QString CommitInfo::ZERO_SHA = QString("0000000000000000000000000000000000000000");
+const ObjectId CommitInfo::ZERO_ID = ObjectId::fromHex(CommitInfo::ZERO_SHA);
 
 CommitInfo::CommitInfo(const QString &sha, const QStringList &parents, const QString &author, long long secsSinceEpoch,
                        const QString &log, const QString &longLog, int idx)
 {
-   mSha = sha;
-   mParentsSha = parents;
+   mId = ObjectId::fromHex(sha);
+
+   for (const auto &parent : parents)
+      mParents.append(ObjectId::fromHex(parent));
+
    mCommitter = author;
    mAuthor = author;
    mCommitDate = QDateTime::fromSecsSinceEpoch(secsSinceEpoch);
@@ -17,36 +29,86 @@ CommitInfo::CommitInfo(const QString &sha, const QStringList &parents, const QSt
    orderIdx = idx;
 }
 
+CommitInfo::CommitInfo(const ObjectId &id, const QVector<ObjectId> &parents, const QDateTime &commitDate, int idx)
+   : orderIdx(idx)
+   , mId(id)
+   , mParents(parents)
+   , mCommitDate(commitDate)
+{
+}
+
 CommitInfo::CommitInfo(const QByteArray &b, int idx)
    : orderIdx(idx)
 {
-   const auto fields = QString::fromUtf8(b).split('\n');
+   // The record is parsed in place: "log size", SHAs, committer, author, date and short log are one line each. The long
+   // log is not part of the record, it is loaded on demand. Only the fields that are shown to the user are decoded from
+   // UTF-8.
+   const auto data = b.constData();
+   const auto size = b.size();
+   int lineStart[HEADER_LINES];
+   int lineEnd[HEADER_LINES];
+   auto pos = 0;
+
+   for (auto i = 0; i < HEADER_LINES; ++i)
+   {
+      const auto newLine = static_cast<const char *>(memchr(data + pos, '\n', static_cast<size_t>(size - pos)));
+
+      if (!newLine)
+         return;
+
+      lineStart[i] = pos;
+      lineEnd[i] = static_cast<int>(newLine - data);
+      pos = lineEnd[i] + 1;
+   }
+
+   // <boundary mark><SHA>X<parent SHA> <parent SHA>...
+   const auto shaStart = lineStart[1] + 1;
+   const auto separator = shaStart < lineEnd[1]
+       ? static_cast<const char *>(memchr(data + shaStart, 'X', static_cast<size_t>(lineEnd[1] - shaStart)))
+       : nullptr;
+
+   if (!separator)
+      return;
 
-   if (fields.count() > 6)
+   const auto shaEnd = static_cast<int>(separator - data);
+   const auto id = ObjectId::fromHex(data + shaStart, shaEnd - shaStart);
+
+   if (id.isNull())
+      return;
+
+   mBoundaryInfo = QChar::fromLatin1(data[lineStart[1]]);
+   mId = id;
+
+   for (auto parentStart = shaEnd + 1; parentStart < lineEnd[1];)
    {
-      auto combinedShas = fields.at(1);
-      auto sha = combinedShas.split('X').first();
-      mBoundaryInfo = sha.at(0);
-      sha.remove(0, 1);
-      mSha = sha;
-      combinedShas = combinedShas.remove(0, mSha.size() + 1 + 1);
-      mParentsSha = combinedShas.trimmed().split(' ', QString::SkipEmptyParts);
-      mCommitter = fields.at(2);
-      mAuthor = fields.at(3);
-      mCommitDate = QDateTime::fromSecsSinceEpoch(fields.at(4).toInt());
-      mShortLog = fields.at(5);
-
-      for (auto i = 6; i < fields.count(); ++i)
-         mLongLog += fields.at(i);
+      auto parentEnd = parentStart;
+
+      while (parentEnd < lineEnd[1] && data[parentEnd] != ' ')
+         ++parentEnd;
+
+      if (parentEnd > parentStart)
+         mParents.append(ObjectId::fromHex(data + parentStart, parentEnd - parentStart));
+
+      parentStart = parentEnd + 1;
    }
+
+   mCommitter = QString::fromUtf8(data + lineStart[2], lineEnd[2] - lineStart[2]);
+   mAuthor = QString::fromUtf8(data + lineStart[3], lineEnd[3] - lineStart[3]);
+
+   auto secsSinceEpoch = 0LL;
+
+   for (auto i = lineStart[4]; i < lineEnd[4] && data[i] >= '0' && data[i] <= '9'; ++i)
+      secsSinceEpoch = secsSinceEpoch * 10 + (data[i] - '0');
+
+   mCommitDate = QDateTime::fromSecsSinceEpoch(secsSinceEpoch);
+   mShortLog = QString::fromUtf8(data + lineStart[5], lineEnd[5] - lineStart[5]);
 }
 
 bool CommitInfo::operator==(const CommitInfo &commit) const
 {
-   return (mSha == commit.mSha || mSha.startsWith(commit.sha()) || commit.sha().startsWith(mSha))
-       && mParentsSha == commit.mParentsSha && mCommitter == commit.mCommitter && mAuthor == commit.mAuthor
-       && mCommitDate == commit.mCommitDate && mShortLog == commit.mShortLog && mLongLog == commit.mLongLog
-       && orderIdx == commit.orderIdx && lanes == commit.lanes;
+   return mId == commit.mId && mParents == commit.mParents && mCommitter == commit.mCommitter
+       && mAuthor == commit.mAuthor && mCommitDate == commit.mCommitDate && mShortLog == commit.mShortLog
+       && mLongLog == commit.mLongLog && orderIdx == commit.orderIdx && lanes == commit.lanes;
 }
 
 bool CommitInfo::operator!=(const CommitInfo &commit) const
@@ -77,9 +139,17 @@ QString CommitInfo::getFieldStr(CommitInfo::Field field) const
    }
 }
 
-bool CommitInfo::isValid() const
+QStringList CommitInfo::parents() const
 {
-   QRegExp hexMatcher("^[0-9A-F]{40}$", Qt::CaseInsensitive);
+   QStringList parents;
+
+   for (const auto &parent : mParents)
+      parents.append(parent.toHex());
 
-   return !mSha.isEmpty() && hexMatcher.exactMatch(mSha);
+   return parents;
+}
+
+bool CommitInfo::isValid() const
+{
+   return !mId.isNull();
 }
@@ -23,6 +23,8 @@
  ** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
  ***************************************************************************************/
 
+#include <ObjectId.h>
+
 #include <QVector>
 #include <QStringList>
 #include <QDateTime>
@@ -47,17 +49,23 @@ public:
    CommitInfo(const QString &sha, const QStringList &parents, const QString &author, long long secsSinceEpoch,
               const QString &log, const QString &longLog, int idx);
    CommitInfo(const QByteArray &b, int idx);
+   // Commit that only has its place in the graph. The texts are filled later.
+   CommitInfo(const ObjectId &id, const QVector<ObjectId> &parents, const QDateTime &commitDate, int idx);
    bool operator==(const CommitInfo &commit) const;
    bool operator!=(const CommitInfo &commit) const;
    QString getFieldStr(CommitInfo::Field field) const;
    bool isBoundary() const { return mBoundaryInfo == '-'; }
-   int parentsCount() const { return mParentsSha.count(); }
-   QString parent(int idx) const { return mParentsSha.count() > idx ? mParentsSha.at(idx) : QString(); }
-   QStringList parents() const { return mParentsSha; }
-   QString sha() const { return mSha; }
+   int parentsCount() const { return mParents.count(); }
+   QString parent(int idx) const { return parentId(idx).toHex(); }
+   ObjectId parentId(int idx) const { return mParents.count() > idx ? mParents.at(idx) : ObjectId(); }
+   QStringList parents() const;
+   QVector<ObjectId> parentIds() const { return mParents; }
+   QString sha() const { return mId.toHex(); }
+   ObjectId id() const { return mId; }
    QString committer() const { return mCommitter; }
    QString author() const { return mAuthor; }
    QString authorDate() const { return QString::number(mCommitDate.toSecsSinceEpoch()); }
+   QDateTime date() const { return mCommitDate; }
    QString shortLog() const { return mShortLog; }
    QString longLog() const { return mLongLog; }
    QString fullLog() const { return QString("%1\n\n%2").arg(mShortLog, mLongLog.trimmed()); }
@@ -68,11 +76,14 @@ public:
    bool isDiffCache = false;
 
    static const QString ZERO_SHA;
+   static const ObjectId ZERO_ID;
 
 private:
+   friend class CommitStore;
+
    QChar mBoundaryInfo;
-   QString mSha;
-   QStringList mParentsSha;
+   ObjectId mId;
+   QVector<ObjectId> mParents;
    QString mCommitter;
    QString mAuthor;
    QDateTime mCommitDate;
@@ -0,0 +1,161 @@
+#include "CommitSearchIndex.h"
+
+#include <algorithm>
+#include <iterator>
+
+namespace
+{
+const int TRIGRAM_SIZE = 3;
+
+quint64 trigram(const QString &word, int position)
+{
+   return (static_cast<quint64>(word.at(position).unicode()) << 32)
+       | (static_cast<quint64>(word.at(position + 1).unicode()) << 16) | word.at(position + 2).unicode();
+}
+
+QVector<int> intersect(const QVector<int> &first, const QVector<int> &second)
+{
+   QVector<int> result;
+   std::set_intersection(first.cbegin(), first.cend(), second.cbegin(), second.cend(), std::back_inserter(result));
+
+   return result;
+}
+}
+
+void CommitSearchIndex::clear()
+{
+   mWordIds.clear();
+   mWords.clear();
+   mPostings.clear();
+   mTrigrams.clear();
+}
+
+void CommitSearchIndex::addCommit(int id, const QString &text)
+{
+   for (const auto &word : words(text))
+   {
+      auto wordId = mWordIds.value(word, -1);
+
+      if (wordId == -1)
+      {
+         wordId = mWords.count();
+         mWordIds.insert(word, wordId);
+         mWords.append(word);
+         mPostings.append(QVector<int>());
+
+         // The word ids are added in order, so the lists of the trigrams are sorted
+         for (auto i = 0; i + TRIGRAM_SIZE <= word.size(); ++i)
+         {
+            auto &trigramWords = mTrigrams[trigram(word, i)];
+
+            if (trigramWords.isEmpty() || trigramWords.constLast() != wordId)
+               trigramWords.append(wordId);
+         }
+      }
+
+      auto &commits = mPostings[wordId];
+
+      // The commits are usually added in order, the others are moved to their place
+      if (commits.isEmpty() || commits.constLast() < id)
+         commits.append(id);
+      else
+      {
+         const auto position = std::lower_bound(commits.begin(), commits.end(), id);
+
+         if (*position != id)
+            commits.insert(position, id);
+      }
+   }
+}
+
+QVector<int> CommitSearchIndex::find(const QString &text) const
+{
+   const auto pieces = words(text);
+   QVector<int> commits;
+
+   for (auto i = 0; i < pieces.count(); ++i)
+   {
+      commits = i == 0 ? findCommits(pieces.at(i)) : intersect(commits, findCommits(pieces.at(i)));
+
+      if (commits.isEmpty())
+         break;
+   }
+
+   return commits;
+}
+
+QStringList CommitSearchIndex::words(const QString &text)
+{
+   QStringList words;
+   QString word;
+
+   for (const auto character : text)
+   {
+      if (character.isLetterOrNumber())
+         word.append(character.toLower());
+      else if (!word.isEmpty())
+      {
+         words.append(word);
+         word.clear();
+      }
+   }
+
+   if (!word.isEmpty())
+      words.append(word);
+
+   words.removeDuplicates();
+
+   return words;
+}
+
+QVector<int> CommitSearchIndex::findWords(const QString &piece) const
+{
+   QVector<int> candidates;
+
+   if (piece.size() < TRIGRAM_SIZE)
+   {
+      // Too short for the trigrams, but the dictionary is much smaller than the history
+      for (auto wordId = 0; wordId < mWords.count(); ++wordId)
+      {
+         if (mWords.at(wordId).contains(piece))
+            candidates.append(wordId);
+      }
+
+      return candidates;
+   }
+
+   for (auto i = 0; i + TRIGRAM_SIZE <= piece.size(); ++i)
+   {
+      const auto trigramWords = mTrigrams.value(trigram(piece, i));
+
+      candidates = i == 0 ? trigramWords : intersect(candidates, trigramWords);
+
+      if (candidates.isEmpty())
+         return candidates;
+   }
+
+   // Having all the trigrams doesn't mean having them together
+   candidates.erase(std::remove_if(candidates.begin(), candidates.end(),
+                                   [this, &piece](int wordId) { return !mWords.at(wordId).contains(piece); }),
+                    candidates.end());
+
+   return candidates;
+}
+
+QVector<int> CommitSearchIndex::findCommits(const QString &piece) const
+{
+   const auto wordIds = findWords(piece);
+
+   if (wordIds.count() == 1)
+      return mPostings.at(wordIds.constFirst());
+
+   QVector<int> commits;
+
+   for (const auto wordId : wordIds)
+      commits += mPostings.at(wordId);
+
+   std::sort(commits.begin(), commits.end());
+   commits.erase(std::unique(commits.begin(), commits.end()), commits.end());
+
+   return commits;
+}
@@ -0,0 +1,61 @@
+#pragma once
+
+/****************************************************************************************
+ ** GitQlient is an application to manage and operate one or several Git repositories. With
+ ** GitQlient you will be able to add commits, branches and manage all the options Git provides.
+ ** Copyright (C) 2019  Francesc Martinez
+ **
+ ** LinkedIn: www.linkedin.com/in/cescmm/
+ ** Web: www.francescmm.com
+ **
+ ** This program is free software; you can redistribute it and/or
+ ** modify it under the terms of the GNU Lesser General Public
+ ** License as published by the Free Software Foundation; either
+ ** version 2 of the License, or (at your option) any later version.
+ **
+ ** This program is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ ** Lesser General Public License for more details.
+ **
+ ** You should have received a copy of the GNU Lesser General Public
+ ** License along with this library; if not, write to the Free Software
+ ** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ***************************************************************************************/
+
+#include <QHash>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+// Inverted index of the words of the commits, to search the history without going through all the commits. The
+// commits are identified by their dense id in the CommitStore, so the index doesn't change when rows are inserted.
+//
+// The words are lowercase. Every word of the dictionary is also indexed by its trigrams, so a piece of a word finds
+// the words that contain it without going through the dictionary.
+class CommitSearchIndex
+{
+public:
+   CommitSearchIndex() = default;
+
+   void clear();
+   bool isEmpty() const { return mWords.isEmpty(); }
+
+   // Adds the words of the text to the commit. A commit can get more words later, like the ones of its body.
+   void addCommit(int id, const QString &text);
+
+   // Returns the sorted ids of the commits that have all the words of the text. Each word of the text matches the
+   // words of the commits that contain it, so "fix" finds "Fixed" and "prefix".
+   QVector<int> find(const QString &text) const;
+
+   static QStringList words(const QString &text);
+
+private:
+   QHash<QString, int> mWordIds;
+   QVector<QString> mWords;
+   QVector<QVector<int>> mPostings;
+   QHash<quint64, QVector<int>> mTrigrams;
+
+   QVector<int> findWords(const QString &piece) const;
+   QVector<int> findCommits(const QString &piece) const;
+};
@@ -0,0 +1,327 @@
+#include "CommitStore.h"
+
+#include <algorithm>
+
+namespace
+{
+// Approximated sizes of the Qt containers used to estimate the memory of the store
+const qint64 HEAP_BLOCK_OVERHEAD = 16;
+const qint64 ARRAY_DATA_HEADER = 24;
+const qint64 DATE_TIME_DATA = 48;
+const qint64 HASH_NODE = 32;
+
+qint64 stringFootprint(int size)
+{
+   return ARRAY_DATA_HEADER + (size + 1) * static_cast<qint64>(sizeof(QChar)) + HEAP_BLOCK_OVERHEAD;
+}
+
+template<typename T>
+qint64 vectorFootprint(const QVector<T> &vector)
+{
+   return ARRAY_DATA_HEADER + vector.capacity() * static_cast<qint64>(sizeof(T)) + HEAP_BLOCK_OVERHEAD;
+}
+}
+
+void CommitStore::clear()
+{
+   mArena.clear();
+   mIdsBySha.clear();
+   mIdShas.clear();
+   mIdRows.clear();
+   mRowIds.clear();
+   mBoundaryInfo.clear();
+   mCommitters.clear();
+   mAuthors.clear();
+   mShortLogs.clear();
+   mDates.clear();
+   mIsDiffCache.clear();
+   mParentsOffset = { 0 };
+   mParentIds.clear();
+}
+
+void CommitStore::reserve(int commits)
+{
+   mIdsBySha.reserve(commits);
+   mIdShas.reserve(commits);
+   mIdRows.reserve(commits);
+   mRowIds.reserve(commits);
+   mBoundaryInfo.reserve(commits);
+   mCommitters.reserve(commits);
+   mAuthors.reserve(commits);
+   mShortLogs.reserve(commits);
+   mDates.reserve(commits);
+   mIsDiffCache.reserve(commits);
+   mParentsOffset.reserve(commits + 1);
+}
+
+int CommitStore::internId(const ObjectId &sha)
+{
+   if (sha.isNull())
+      return -1;
+
+   auto id = mIdsBySha.value(sha, -1);
+
+   if (id == -1)
+   {
+      id = mIdShas.count();
+      mIdsBySha.insert(sha, id);
+      mIdShas.append(sha);
+      mIdRows.append(-1);
+   }
+
+   return id;
+}
+
+QVector<int> CommitStore::internIds(const QVector<ObjectId> &shas)
+{
+   QVector<int> ids;
+   ids.reserve(shas.count());
+
+   for (const auto &sha : shas)
+      ids.append(internId(sha));
+
+   return ids;
+}
+
+int CommitStore::append(const CommitInfo &commit)
+{
+   return append(commit, internId(commit.mId), internIds(commit.mParents));
+}
+
+int CommitStore::append(const CommitInfo &commit, int id, const QVector<int> &parentIds)
+{
+   const auto row = count();
+
+   if (id != -1)
+      mIdRows[id] = row;
+
+   mRowIds.append(id);
+   mBoundaryInfo.append(commit.mBoundaryInfo);
+   mCommitters.append(storeString(commit.mCommitter));
+   mAuthors.append(storeString(commit.mAuthor));
+   mShortLogs.append(storeString(commit.mShortLog));
+   mDates.append(commit.mCommitDate.isValid() ? commit.mCommitDate.toSecsSinceEpoch() : 0);
+   mIsDiffCache.append(commit.isDiffCache ? 1 : 0);
+
+   mParentIds.append(parentIds);
+   mParentsOffset.append(mParentIds.count());
+
+   return row;
+}
+
+void CommitStore::setDetails(int row, const CommitInfo &commit)
+{
+   mCommitters[row] = storeString(commit.mCommitter);
+   mAuthors[row] = storeString(commit.mAuthor);
+   mShortLogs[row] = storeString(commit.mShortLog);
+
+   // The commit-graph only has the committer date, the column keeps the author date of the log like the other rows
+   if (commit.mCommitDate.isValid())
+      mDates[row] = commit.mCommitDate.toSecsSinceEpoch();
+}
+
+void CommitStore::insert(int row, const QVector<CommitInfo> &commits)
+{
+   // The new rows are spliced into the columns. The texts go to the end of the arena and the SHAs keep their ids, so
+   // the rows below only move.
+   const auto total = commits.count();
+
+   if (total == 0)
+      return;
+
+   for (auto &idRow : mIdRows)
+   {
+      if (idRow >= row)
+         idRow += total;
+   }
+
+   mRowIds.insert(row, total, -1);
+   mBoundaryInfo.insert(row, total, QChar());
+   mCommitters.insert(row, total, StringRef());
+   mAuthors.insert(row, total, StringRef());
+   mShortLogs.insert(row, total, StringRef());
+   mDates.insert(row, total, 0);
+   mIsDiffCache.insert(row, total, 0);
+   mParentsOffset.insert(row + 1, total, 0);
+
+   const auto parentsStart = mParentsOffset.at(row);
+   QVector<int> parentIds;
+
+   for (auto i = 0; i < total; ++i)
+   {
+      const auto &commit = commits.at(i);
+      const auto id = internId(commit.mId);
+
+      if (id != -1)
+         mIdRows[id] = row + i;
+
+      mRowIds[row + i] = id;
+      mBoundaryInfo[row + i] = commit.mBoundaryInfo;
+      mCommitters[row + i] = storeString(commit.mCommitter);
+      mAuthors[row + i] = storeString(commit.mAuthor);
+      mShortLogs[row + i] = storeString(commit.mShortLog);
+      mDates[row + i] = commit.mCommitDate.isValid() ? commit.mCommitDate.toSecsSinceEpoch() : 0;
+      mIsDiffCache[row + i] = commit.isDiffCache ? 1 : 0;
+
+      parentIds.append(internIds(commit.mParents));
+      mParentsOffset[row + i + 1] = parentsStart + parentIds.count();
+   }
+
+   for (auto i = row + total + 1; i < mParentsOffset.count(); ++i)
+      mParentsOffset[i] += parentIds.count();
+
+   mParentIds.insert(parentsStart, parentIds.count(), -1);
+   std::copy(parentIds.cbegin(), parentIds.cend(), mParentIds.begin() + parentsStart);
+}
+
+int CommitStore::findRow(const ObjectId &sha) const
+{
+   const auto id = mIdsBySha.value(sha, -1);
+
+   return id != -1 ? mIdRows.at(id) : -1;
+}
+
+CommitInfo CommitStore::commit(int row) const
+{
+   CommitInfo commit;
+
+   if (row >= 0 && row < count() && mRowIds.at(row) != -1)
+   {
+      commit.mId = id(row);
+      commit.mBoundaryInfo = mBoundaryInfo.at(row);
+      commit.mCommitter = string(mCommitters.at(row));
+      commit.mAuthor = string(mAuthors.at(row));
+      commit.mShortLog = string(mShortLogs.at(row));
+      commit.mCommitDate = QDateTime::fromSecsSinceEpoch(mDates.at(row));
+      commit.orderIdx = row;
+      commit.isDiffCache = mIsDiffCache.at(row) != 0;
+
+      const auto totalParents = parentsCount(row);
+
+      for (auto i = 0; i < totalParents; ++i)
+         commit.mParents.append(parent(row, i));
+   }
+
+   return commit;
+}
+
+ObjectId CommitStore::id(int row) const
+{
+   const auto id = row >= 0 && row < count() ? mRowIds.at(row) : -1;
+
+   return id != -1 ? mIdShas.at(id) : ObjectId();
+}
+
+QString CommitStore::fieldStr(int row, CommitInfo::Field field) const
+{
+   if (row < 0 || row >= count())
+      return QString();
+
+   switch (field)
+   {
+      case CommitInfo::Field::SHA:
+         return sha(row);
+      case CommitInfo::Field::PARENTS_SHA: {
+         QStringList parents;
+         const auto totalParents = parentsCount(row);
+
+         for (auto i = 0; i < totalParents; ++i)
+            parents.append(parent(row, i).toHex());
+
+         return parents.join(",");
+      }
+      case CommitInfo::Field::COMMITER:
+         return string(mCommitters.at(row));
+      case CommitInfo::Field::AUTHOR:
+         return string(mAuthors.at(row));
+      case CommitInfo::Field::DATE:
+         return QString::number(mDates.at(row));
+      case CommitInfo::Field::SHORT_LOG:
+         return string(mShortLogs.at(row));
+      default:
+         return QString();
+   }
+}
+
+int CommitStore::parentsCount(int row) const
+{
+   return mParentsOffset.at(row + 1) - mParentsOffset.at(row);
+}
+
+ObjectId CommitStore::parent(int row, int idx) const
+{
+   const auto id = idx < parentsCount(row) ? mParentIds.at(mParentsOffset.at(row) + idx) : -1;
+
+   return id != -1 ? mIdShas.at(id) : ObjectId();
+}
+
+QVector<int> CommitStore::parentIds(int row) const
+{
+   const auto start = mParentsOffset.at(row);
+
+   return mParentIds.mid(start, mParentsOffset.at(row + 1) - start);
+}
+
+QVector<ObjectId> CommitStore::ids() const
+{
+   QVector<ObjectId> ids;
+   ids.reserve(count());
+
+   for (auto row = 0; row < count(); ++row)
+   {
+      if (mRowIds.at(row) != -1)
+         ids.append(id(row));
+   }
+
+   return ids;
+}
+
+qint64 CommitStore::memoryFootprint() const
+{
+   auto total = ARRAY_DATA_HEADER + mArena.capacity() * static_cast<qint64>(sizeof(QChar)) + HEAP_BLOCK_OVERHEAD;
+
+   total += mIdsBySha.capacity() * static_cast<qint64>(sizeof(void *))
+       + mIdsBySha.count() * (HASH_NODE + static_cast<qint64>(sizeof(ObjectId)) + HEAP_BLOCK_OVERHEAD);
+
+   total += vectorFootprint(mIdShas) + vectorFootprint(mIdRows) + vectorFootprint(mRowIds)
+       + vectorFootprint(mBoundaryInfo) + vectorFootprint(mCommitters) + vectorFootprint(mAuthors)
+       + vectorFootprint(mShortLogs) + vectorFootprint(mDates)
+       + vectorFootprint(mIsDiffCache) + vectorFootprint(mParentsOffset) + vectorFootprint(mParentIds);
+
+   return total;
+}
+
+qint64 CommitStore::legacyMemoryFootprint() const
+{
+   // Estimation of a QVector<CommitInfo *> plus a QHash<QString, CommitInfo *> holding the same commits. It's taken
+   // from the totals of the columns instead of walking the rows: the texts of the arena are counted once, as if each
+   // one was its own QString.
+   const qint64 commits = count();
+   const auto shaSize = mIdShas.isEmpty() ? 40 : 2 * mIdShas.constFirst().size();
+
+   // The object and its pointer, the SHA, the empty headers of the texts, the date, the list of parents and the node
+   // of the hash
+   const auto perCommit = static_cast<qint64>(sizeof(CommitInfo *)) + static_cast<qint64>(sizeof(CommitInfo))
+       + HEAP_BLOCK_OVERHEAD + stringFootprint(shaSize) + 3 * stringFootprint(0) + DATE_TIME_DATA
+       + HEAP_BLOCK_OVERHEAD + ARRAY_DATA_HEADER + HEAP_BLOCK_OVERHEAD + static_cast<qint64>(sizeof(void *))
+       + HASH_NODE + HEAP_BLOCK_OVERHEAD;
+
+   return commits * perCommit + mArena.size() * static_cast<qint64>(sizeof(QChar))
+       + mParentIds.count() * (static_cast<qint64>(sizeof(void *)) + stringFootprint(shaSize));
+}
+
+CommitStore::StringRef CommitStore::storeString(const QString &text)
+{
+   StringRef ref;
+   ref.offset = mArena.size();
+   ref.size = text.size();
+
+   mArena.append(text);
+
+   return ref;
+}
+
+QString CommitStore::string(const StringRef &ref) const
+{
+   return ref.size == 0 ? QString() : QString(mArena.constData() + ref.offset, ref.size);
+}
@@ -0,0 +1,110 @@
+#pragma once
+
+/****************************************************************************************
+ ** GitQlient is an application to manage and operate one or several Git repositories. With
+ ** GitQlient you will be able to add commits, branches and manage all the options Git provides.
+ ** Copyright (C) 2019  Francesc Martinez
+ **
+ ** LinkedIn: www.linkedin.com/in/cescmm/
+ ** Web: www.francescmm.com
+ **
+ ** This program is free software; you can redistribute it and/or
+ ** modify it under the terms of the GNU Lesser General Public
+ ** License as published by the Free Software Foundation; either
+ ** version 2 of the License, or (at your option) any later version.
+ **
+ ** This program is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ ** Lesser General Public License for more details.
+ **
+ ** You should have received a copy of the GNU Lesser General Public
+ ** License along with this library; if not, write to the Free Software
+ ** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ***************************************************************************************/
+
+#include <CommitInfo.h>
+#include <ObjectId.h>
+
+#include <QHash>
+#include <QString>
+#include <QVector>
+
+// The CommitStore keeps the commits of the repository by columns instead of having one object per commit. The texts of
+// all the commits live in a single arena and each row only keeps where its texts are. The parents are stored as indexes
+// to an internal table of SHAs so they can be resolved without string comparisons.
+//
+// The row of a commit in the store is the same than its row in the history view.
+class CommitStore
+{
+public:
+   CommitStore() = default;
+
+   void clear();
+   void reserve(int commits);
+   int count() const { return mRowIds.count(); }
+
+   // Returns the dense id of the SHA in the store, adding it if it wasn't known yet. Null SHAs get -1.
+   int internId(const ObjectId &sha);
+   QVector<int> internIds(const QVector<ObjectId> &shas);
+   int append(const CommitInfo &commit);
+   int append(const CommitInfo &commit, int id, const QVector<int> &parentIds);
+   // Inserts the commits before the given row
+   void insert(int row, const QVector<CommitInfo> &commits);
+   // Replaces the texts and the date of the row with the ones of the commit. The place in the graph is kept.
+   void setDetails(int row, const CommitInfo &commit);
+   // The rows loaded from the commit-graph have no texts until their details are set
+   bool hasDetails(int row) const { return mCommitters.at(row).size != 0; }
+   int findRow(const ObjectId &id) const;
+   // Row of a dense id, -1 if the commit is not loaded (like the parents of the boundary commits)
+   int idRow(int id) const { return id >= 0 ? mIdRows.at(id) : -1; }
+
+   CommitInfo commit(int row) const;
+   ObjectId id(int row) const;
+   int rowId(int row) const { return mRowIds.at(row); }
+   bool isBoundary(int row) const { return mBoundaryInfo.at(row) == '-'; }
+   QString sha(int row) const { return id(row).toHex(); }
+   QString fieldStr(int row, CommitInfo::Field field) const;
+   qint64 date(int row) const { return mDates.at(row); }
+   int parentsCount(int row) const;
+   ObjectId parent(int row, int idx) const;
+   QVector<int> parentIds(int row) const;
+   QVector<ObjectId> ids() const;
+
+   qint64 memoryFootprint() const;
+   // Rough memory the same commits would take with one object per commit
+   qint64 legacyMemoryFootprint() const;
+
+private:
+   friend class CommitStoreFile;
+
+   struct StringRef
+   {
+      int offset = 0;
+      int size = 0;
+   };
+
+   QString mArena;
+
+   // One entry per SHA known by the store (commits and parents)
+   QHash<ObjectId, int> mIdsBySha;
+   QVector<ObjectId> mIdShas;
+   QVector<int> mIdRows;
+
+   // One entry per row
+   QVector<int> mRowIds;
+   QVector<QChar> mBoundaryInfo;
+   QVector<StringRef> mCommitters;
+   QVector<StringRef> mAuthors;
+   QVector<StringRef> mShortLogs;
+   QVector<qint64> mDates;
+   // Bytes instead of bools, so any value read from a file is valid
+   QVector<quint8> mIsDiffCache;
+   QVector<int> mParentsOffset { 0 };
+
+   // Pools indexed by the offsets
+   QVector<int> mParentIds;
+
+   StringRef storeString(const QString &text);
+   QString string(const StringRef &ref) const;
+};
@@ -0,0 +1,219 @@
+#include "CommitStoreFile.h"
+
+#include <CommitStore.h>
+
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+
+#include <QLogger.h>
+
+#include <algorithm>
+
+using namespace QLogger;
+
+namespace
+{
+const quint32 FILE_MAGIC = 0x47514853; // "GQHS"
+// Must change every time the layout of the file or of the columns of the CommitStore changes
+const quint32 FILE_VERSION = 4;
+
+struct FileHeader
+{
+   quint32 magic;
+   quint32 version;
+   quint32 objectIdSize;
+};
+
+template<typename T>
+void writeColumn(QSaveFile &file, const QVector<T> &column)
+{
+   const auto count = static_cast<quint32>(column.count());
+
+   file.write(reinterpret_cast<const char *>(&count), sizeof(count));
+   file.write(reinterpret_cast<const char *>(column.constData()), static_cast<qint64>(count * sizeof(T)));
+}
+
+void writeString(QSaveFile &file, const QString &text)
+{
+   const auto count = static_cast<quint32>(text.size());
+
+   file.write(reinterpret_cast<const char *>(&count), sizeof(count));
+   file.write(reinterpret_cast<const char *>(text.constData()), static_cast<qint64>(count * sizeof(QChar)));
+}
+
+bool isValidId(const ObjectId &id)
+{
+   return id.size() == ObjectId::SHA1_SIZE || id.size() == ObjectId::SHA256_SIZE;
+}
+
+template<typename T>
+bool isInRange(const QVector<T> &values, T min, T max)
+{
+   return std::all_of(values.cbegin(), values.cend(), [min, max](T value) { return value >= min && value < max; });
+}
+
+class MappedReader
+{
+public:
+   MappedReader(const uchar *data, qint64 size)
+      : mCurrent(data)
+      , mEnd(data + size)
+   {
+   }
+
+   template<typename T>
+   bool read(T &value)
+   {
+      if (mEnd - mCurrent < static_cast<qint64>(sizeof(T)))
+         return false;
+
+      memcpy(&value, mCurrent, sizeof(T));
+      mCurrent += sizeof(T);
+
+      return true;
+   }
+
+   template<typename T>
+   bool readColumn(QVector<T> &column)
+   {
+      quint32 count = 0;
+
+      if (!read(count) || static_cast<quint64>(mEnd - mCurrent) < count * static_cast<quint64>(sizeof(T)))
+         return false;
+
+      column.resize(static_cast<int>(count));
+      memcpy(static_cast<void *>(column.data()), mCurrent, count * sizeof(T));
+      mCurrent += count * sizeof(T);
+
+      return true;
+   }
+
+   bool readString(QString &text)
+   {
+      QVector<QChar> chars;
+
+      if (!readColumn(chars))
+         return false;
+
+      text = QString(chars.constData(), chars.count());
+
+      return true;
+   }
+
+   bool atEnd() const { return mCurrent == mEnd; }
+
+private:
+   const uchar *mCurrent;
+   const uchar *mEnd;
+};
+}
+
+bool CommitStoreFile::write(const QString &path, const ObjectId &head, const QVector<ObjectId> &tips,
+                            const CommitStore &store)
+{
+   QDir().mkpath(QFileInfo(path).absolutePath());
+
+   QSaveFile file(path);
+
+   if (!file.open(QIODevice::WriteOnly))
+   {
+      QLog_Warning("Git", QString("Unable to write the history cache {%1}: %2").arg(path, file.errorString()));
+      return false;
+   }
+
+   const FileHeader header { FILE_MAGIC, FILE_VERSION, sizeof(ObjectId) };
+
+   file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+   file.write(reinterpret_cast<const char *>(&head), sizeof(head));
+
+   writeColumn(file, tips);
+   writeString(file, store.mArena);
+   writeColumn(file, store.mIdShas);
+   writeColumn(file, store.mIdRows);
+   writeColumn(file, store.mRowIds);
+   writeColumn(file, store.mBoundaryInfo);
+   writeColumn(file, store.mCommitters);
+   writeColumn(file, store.mAuthors);
+   writeColumn(file, store.mShortLogs);
+   writeColumn(file, store.mDates);
+   writeColumn(file, store.mIsDiffCache);
+   writeColumn(file, store.mParentsOffset);
+   writeColumn(file, store.mParentIds);
+
+   return file.commit();
+}
+
+bool CommitStoreFile::read(const QString &path, ObjectId &head, QVector<ObjectId> &tips, CommitStore &store)
+{
+   QFile file(path);
+
+   if (!file.open(QIODevice::ReadOnly))
+      return false;
+
+   const auto data = file.map(0, file.size());
+
+   if (!data)
+   {
+      QLog_Warning("Git", QString("Unable to map the history cache {%1}: %2").arg(path, file.errorString()));
+      return false;
+   }
+
+   MappedReader reader(data, file.size());
+   FileHeader header {};
+   CommitStore loaded;
+
+   auto ok = reader.read(header) && header.magic == FILE_MAGIC && header.version == FILE_VERSION
+       && header.objectIdSize == sizeof(ObjectId);
+
+   ok = ok && reader.read(head) && reader.readColumn(tips) && reader.readString(loaded.mArena)
+       && reader.readColumn(loaded.mIdShas) && reader.readColumn(loaded.mIdRows) && reader.readColumn(loaded.mRowIds)
+       && reader.readColumn(loaded.mBoundaryInfo) && reader.readColumn(loaded.mCommitters)
+       && reader.readColumn(loaded.mAuthors) && reader.readColumn(loaded.mShortLogs) && reader.readColumn(loaded.mDates)
+       && reader.readColumn(loaded.mIsDiffCache) && reader.readColumn(loaded.mParentsOffset)
+       && reader.readColumn(loaded.mParentIds) && reader.atEnd();
+
+   ok = ok && (head.isNull() || isValidId(head)) && std::all_of(tips.cbegin(), tips.cend(), isValidId);
+
+   file.unmap(data);
+
+   if (!ok || !isConsistent(loaded))
+   {
+      QLog_Warning("Git", QString("The history cache {%1} is not valid.").arg(path));
+      return false;
+   }
+
+   loaded.mIdsBySha.reserve(loaded.mIdShas.count());
+
+   for (auto id = 0; id < loaded.mIdShas.count(); ++id)
+      loaded.mIdsBySha.insert(loaded.mIdShas.at(id), id);
+
+   store = std::move(loaded);
+
+   return true;
+}
+
+bool CommitStoreFile::isConsistent(const CommitStore &store)
+{
+   // A damaged file must not end up in indexes out of the columns
+   const auto rows = store.mRowIds.count();
+   const auto ids = store.mIdShas.count();
+   const auto isStringInArena = [arenaSize = store.mArena.size()](const CommitStore::StringRef &ref) {
+      return ref.offset >= 0 && ref.size >= 0 && ref.offset <= arenaSize - ref.size;
+   };
+   const auto areStringsInArena = [isStringInArena](const QVector<CommitStore::StringRef> &refs) {
+      return std::all_of(refs.cbegin(), refs.cend(), isStringInArena);
+   };
+
+   return store.mIdRows.count() == ids && store.mBoundaryInfo.count() == rows && store.mCommitters.count() == rows
+       && store.mAuthors.count() == rows && store.mShortLogs.count() == rows
+       && store.mDates.count() == rows && store.mIsDiffCache.count() == rows
+       && store.mParentsOffset.count() == rows + 1
+       && std::is_sorted(store.mParentsOffset.cbegin(), store.mParentsOffset.cend())
+       && store.mParentsOffset.first() == 0 && store.mParentsOffset.last() == store.mParentIds.count()
+       && isInRange(store.mRowIds, -1, ids) && isInRange(store.mParentIds, -1, ids)
+       && isInRange(store.mIdRows, -1, rows) && std::all_of(store.mIdShas.cbegin(), store.mIdShas.cend(), isValidId)
+       && areStringsInArena(store.mCommitters) && areStringsInArena(store.mAuthors)
+       && areStringsInArena(store.mShortLogs);
+}
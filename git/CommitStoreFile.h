@@ -0,0 +1,49 @@
+#pragma once
+
+/****************************************************************************************
+ ** GitQlient is an application to manage and operate one or several Git repositories. With
+ ** GitQlient you will be able to add commits, branches and manage all the options Git provides.
+ ** Copyright (C) 2019  Francesc Martinez
+ **
+ ** LinkedIn: www.linkedin.com/in/cescmm/
+ ** Web: www.francescmm.com
+ **
+ ** This program is free software; you can redistribute it and/or
+ ** modify it under the terms of the GNU Lesser General Public
+ ** License as published by the Free Software Foundation; either
+ ** version 2 of the License, or (at your option) any later version.
+ **
+ ** This program is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ ** Lesser General Public License for more details.
+ **
+ ** You should have received a copy of the GNU Lesser General Public
+ ** License along with this library; if not, write to the Free Software
+ ** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ***************************************************************************************/
+
+#include <ObjectId.h>
+
+#include <QString>
+#include <QVector>
+
+class CommitStore;
+
+// Reads and writes the CommitStore in a binary file so the history of a repository can be shown without asking git for
+// it again. Besides the columns of the store, the file keeps the HEAD and the tips of the references it was loaded
+// from, so the caller can tell if the file is up to date or which commits are missing.
+//
+// The columns are dumped as they are in memory, but this is a copying loader, not a view over the file: reading maps it
+// only to avoid an intermediate buffer, copies every column into the store, validates it and rebuilds the hash of the
+// SHAs. Opening a repository with an up to date file still costs a pass over the whole history, without asking git.
+class CommitStoreFile
+{
+public:
+   static bool write(const QString &path, const ObjectId &head, const QVector<ObjectId> &tips,
+                     const CommitStore &store);
+   static bool read(const QString &path, ObjectId &head, QVector<ObjectId> &tips, CommitStore &store);
+
+private:
+   static bool isConsistent(const CommitStore &store);
+};
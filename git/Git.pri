@@ -2,14 +2,22 @@ INCLUDEPATH += $$PWD
 
 HEADERS += \
     $$PWD/AGitProcess.h \
+    $$PWD/CommitFilter.h \
+    $$PWD/CommitGraph.h \
     $$PWD/CommitInfo.h \
+    $$PWD/CommitSearchIndex.h \
+    $$PWD/CommitStore.h \
+    $$PWD/CommitStoreFile.h \
+    $$PWD/GitAsync.h \
     $$PWD/GitBase.h \
     $$PWD/GitBranches.h \
     $$PWD/GitCloneProcess.h \
+    $$PWD/GitCommitBodies.h \
     $$PWD/GitConfig.h \
     $$PWD/GitExecResult.h \
     $$PWD/GitHistory.h \
     $$PWD/GitLocal.h \
+    $$PWD/GitObjectService.h \
     $$PWD/GitPatches.h \
     $$PWD/GitRemote.h \
     $$PWD/GitRepoLoader.h \
@@ -18,22 +26,36 @@ HEADERS += \
     $$PWD/GitSubmodules.h \
     $$PWD/GitSyncProcess.h \
     $$PWD/GitTags.h \
+    $$PWD/GraphAlgorithms.h \
+    $$PWD/GraphLanes.h \
+    $$PWD/GraphWalk.h \
+    $$PWD/ObjectId.h \
+    $$PWD/PackedLanes.h \
+    $$PWD/ReachabilityIndex.h \
     $$PWD/Reference.h \
     $$PWD/ReferenceType.h \
     $$PWD/RevisionFiles.h \
     $$PWD/RevisionsCache.h \
+    $$PWD/ShaPrefixIndex.h \
     $$PWD/lanes.h
 
 SOURCES += \
     $$PWD/AGitProcess.cpp \
+    $$PWD/CommitFilter.cpp \
+    $$PWD/CommitGraph.cpp \
     $$PWD/CommitInfo.cpp \
+    $$PWD/CommitSearchIndex.cpp \
+    $$PWD/CommitStore.cpp \
+    $$PWD/CommitStoreFile.cpp \
     $$PWD/GitBase.cpp \
     $$PWD/GitBranches.cpp \
     $$PWD/GitCloneProcess.cpp \
+    $$PWD/GitCommitBodies.cpp \
     $$PWD/GitConfig.cpp \
     $$PWD/GitExecResult.cpp \
     $$PWD/GitHistory.cpp \
     $$PWD/GitLocal.cpp \
+    $$PWD/GitObjectService.cpp \
     $$PWD/GitPatches.cpp \
     $$PWD/GitRemote.cpp \
     $$PWD/GitRepoLoader.cpp \
@@ -42,7 +64,13 @@ SOURCES += \
     $$PWD/GitSubmodules.cpp \
     $$PWD/GitSyncProcess.cpp \
     $$PWD/GitTags.cpp \
+    $$PWD/GraphAlgorithms.cpp \
+    $$PWD/GraphLanes.cpp \
+    $$PWD/ObjectId.cpp \
+    $$PWD/PackedLanes.cpp \
+    $$PWD/ReachabilityIndex.cpp \
     $$PWD/Reference.cpp \
     $$PWD/RevisionFiles.cpp \
     $$PWD/RevisionsCache.cpp \
+    $$PWD/ShaPrefixIndex.cpp \
     $$PWD/lanes.cpp
@@ -0,0 +1,51 @@
+#pragma once
+
+/****************************************************************************************
+ ** GitQlient is an application to manage and operate one or several Git repositories. With
+ ** GitQlient you will be able to add commits, branches and manage all the options Git provides.
+ ** Copyright (C) 2019  Francesc Martinez
+ **
+ ** LinkedIn: www.linkedin.com/in/cescmm/
+ ** Web: www.francescmm.com
+ **
+ ** This program is free software; you can redistribute it and/or
+ ** modify it under the terms of the GNU Lesser General Public
+ ** License as published by the Free Software Foundation; either
+ ** version 2 of the License, or (at your option) any later version.
+ **
+ ** This program is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ ** Lesser General Public License for more details.
+ **
+ ** You should have received a copy of the GNU Lesser General Public
+ ** License along with this library; if not, write to the Free Software
+ ** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ***************************************************************************************/
+
+#include <GitBase.h>
+
+#include <QFutureWatcher>
+#include <QSharedPointer>
+#include <QtConcurrentRun>
+
+// Runs the task in the pool of threads of git and gives its result to the callback in the thread of the receiver. The
+// callback is not called if the receiver is destroyed before. The task gets its own GitBase for the same directory, so
+// no QObject is shared between threads.
+template<typename Task, typename Callback>
+void runGitAsync(const QSharedPointer<GitBase> &git, Task task, QObject *receiver, Callback callback)
+{
+   using Result = decltype(task(QSharedPointer<GitBase>()));
+
+   const auto workingDir = git->getWorkingDir();
+   const auto watcher = new QFutureWatcher<Result>(receiver);
+
+   QObject::connect(watcher, &QFutureWatcherBase::finished, receiver, [watcher, callback]() {
+      callback(watcher->result());
+      watcher->deleteLater();
+   });
+
+   watcher->setFuture(QtConcurrent::run(GitBase::threadPool(), [workingDir, task]() {
+      return task(QSharedPointer<GitBase>::create(workingDir));
+   }));
+}
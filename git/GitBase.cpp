@@ -1,5 +1,6 @@
 #include "GitBase.h"
 
+#include <GitObjectService.h>
 #include <GitRequestorProcess.h>
 #include <GitSyncProcess.h>
 
@@ -7,7 +8,86 @@
 
 using namespace QLogger;
 
+#include <QAtomicInt>
+#include <QCache>
+#include <QDateTime>
 #include <QDir>
+#include <QDirIterator>
+#include <QElapsedTimer>
+#include <QFileInfo>
+#include <QHash>
+#include <QMutex>
+#include <QThread>
+#include <QThreadPool>
+#include <QtConcurrentRun>
+
+namespace
+{
+// git is mostly waiting for the disk, so there can be more processes than cores
+const int MIN_GIT_THREADS = 4;
+// The changes made from outside are noticed after this time at most
+const int FINGERPRINT_INTERVAL_MS = 1000;
+// Characters of output kept for each directory
+const int QUERY_CACHE_MAX_COST = 1024 * 1024;
+
+struct QueryCache
+{
+   QueryCache() { results.setMaxCost(QUERY_CACHE_MAX_COST); }
+
+   QString gitDir;
+   QString commonDir;
+   QByteArray fingerprint;
+   QElapsedTimer fingerprintTimer;
+   int fingerprintCommands = 0;
+   QCache<QString, QPair<bool, QString>> results;
+   QueryCacheStats stats;
+};
+
+// Shared by all the GitBase of the same directory, including the ones of the worker threads
+QMutex queryCacheMutex;
+QHash<QString, QSharedPointer<QueryCache>> queryCaches;
+
+// Commands run without the cache. Any of them could have changed the repository, so the fingerprint is taken again
+// after them.
+QAtomicInt uncachedCommands;
+
+void appendFileState(QByteArray &fingerprint, const QFileInfo &info)
+{
+   fingerprint.append(info.filePath().toUtf8());
+   fingerprint.append(' ');
+
+   if (info.exists())
+      fingerprint.append(QByteArray::number(info.lastModified().toMSecsSinceEpoch()) + ' '
+                         + QByteArray::number(info.size()));
+
+   fingerprint.append('\n');
+}
+
+// The lock file of a loose reference is renamed to the reference when it's updated, and that changes the time of the
+// directory. So it's enough to look at the directories and not at every reference.
+QByteArray repositoryFingerprint(const QString &gitDirPath, const QString &commonDirPath)
+{
+   const QDir gitDir(gitDirPath);
+   const QDir commonDir(commonDirPath);
+   QByteArray fingerprint;
+
+   appendFileState(fingerprint, QFileInfo(gitDir.filePath("HEAD")));
+   appendFileState(fingerprint, QFileInfo(gitDir.filePath("index")));
+   appendFileState(fingerprint, QFileInfo(commonDir.filePath("packed-refs")));
+   appendFileState(fingerprint, QFileInfo(commonDir.filePath("refs")));
+
+   QDirIterator it(commonDir.filePath("refs"), QDir::Dirs | QDir::NoDotAndDotDot | QDir::Hidden,
+                   QDirIterator::Subdirectories);
+
+   while (it.hasNext())
+   {
+      it.next();
+      appendFileState(fingerprint, it.fileInfo());
+   }
+
+   return fingerprint;
+}
+}
 
 GitBase::GitBase(const QString &workingDirectory, QObject *parent)
    : QObject(parent)
@@ -15,10 +95,37 @@ GitBase::GitBase(const QString &workingDirectory, QObject *parent)
 {
 }
 
-QPair<bool, QString> GitBase::run(const QString &runCmd) const
+GitBase::~GitBase() = default;
+
+void GitBase::setWorkingDir(const QString &workingDir)
+{
+   // The processes of the object service run in the old directory
+   if (workingDir != mWorkingDirectory)
+      mObjectService.reset();
+
+   mWorkingDirectory = workingDir;
+}
+
+GitObjectService *GitBase::getObjectService() const
+{
+   if (!mObjectService)
+      mObjectService.reset(new GitObjectService(mWorkingDirectory));
+
+   return mObjectService.data();
+}
+
+QPair<bool, QString> GitBase::run(const QString &runCmd, const QByteArray &input) const
+{
+   uncachedCommands.ref();
+
+   return runProcess(runCmd, input);
+}
+
+QPair<bool, QString> GitBase::runProcess(const QString &runCmd, const QByteArray &input) const
 {
    QString runOutput;
    GitSyncProcess p(mWorkingDirectory);
+   p.setStandardInput(input);
    connect(this, &GitBase::cancelAllProcesses, &p, &AGitProcess::onCancel);
 
    const auto ret = p.run(runCmd, runOutput);
@@ -36,11 +143,130 @@ QPair<bool, QString> GitBase::run(const QString &runCmd) const
    return qMakePair(ret, runOutput);
 }
 
+QFuture<QPair<bool, QString>> GitBase::runAsync(const QString &cmd, const QByteArray &input) const
+{
+   const auto workingDir = mWorkingDirectory;
+
+   return QtConcurrent::run(threadPool(), [workingDir, cmd, input]() { return GitBase(workingDir).run(cmd, input); });
+}
+
+QPair<bool, QString> GitBase::runCached(const QString &cmd) const
+{
+   QMutexLocker lock(&queryCacheMutex);
+
+   auto &cache = queryCaches[mWorkingDirectory];
+
+   if (!cache)
+   {
+      lock.unlock();
+
+      const auto ret = runProcess("git rev-parse --git-dir --git-common-dir", QByteArray());
+      const auto dirs = ret.second.split('\n', QString::SkipEmptyParts);
+
+      // Without the git directory there is no way to know when the result is outdated
+      if (!ret.first || dirs.count() != 2)
+         return run(cmd);
+
+      const QDir workingDir(mWorkingDirectory);
+      const auto resolved = QSharedPointer<QueryCache>::create();
+      resolved->gitDir = workingDir.absoluteFilePath(dirs.at(0).trimmed());
+      resolved->commonDir = workingDir.absoluteFilePath(dirs.at(1).trimmed());
+
+      lock.relock();
+
+      auto &inserted = queryCaches[mWorkingDirectory];
+
+      if (!inserted)
+         inserted = resolved;
+   }
+
+   // The cache is kept alive while the lock is released
+   const auto current = queryCaches.value(mWorkingDirectory);
+   const auto commands = uncachedCommands.load();
+
+   // Taking the fingerprint walks the directories of the references, so it's done without the lock and only when
+   // another command could have changed the repository or after some time for the changes made from outside
+   if (commands != current->fingerprintCommands || !current->fingerprintTimer.isValid()
+       || current->fingerprintTimer.elapsed() >= FINGERPRINT_INTERVAL_MS)
+   {
+      const auto gitDir = current->gitDir;
+      const auto commonDir = current->commonDir;
+
+      lock.unlock();
+
+      const auto fingerprint = repositoryFingerprint(gitDir, commonDir);
+
+      lock.relock();
+
+      if (fingerprint != current->fingerprint)
+      {
+         if (!current->results.isEmpty())
+            QLog_Debug("Git",
+                       QString("The repository changed, query cache cleared ({%1} hits, {%2} misses so far).")
+                           .arg(current->stats.hits)
+                           .arg(current->stats.misses));
+
+         current->fingerprint = fingerprint;
+         current->results.clear();
+      }
+
+      current->fingerprintCommands = commands;
+      current->fingerprintTimer.start();
+   }
+
+   if (const auto cached = current->results.object(cmd))
+   {
+      ++current->stats.hits;
+      return *cached;
+   }
+
+   ++current->stats.misses;
+
+   const auto fingerprint = current->fingerprint;
+
+   lock.unlock();
+
+   const auto ret = runProcess(cmd, QByteArray());
+
+   // Only the results of the same state of the repository can be kept
+   if (ret.first)
+   {
+      lock.relock();
+
+      if (current->fingerprint == fingerprint)
+         current->results.insert(cmd, new QPair<bool, QString>(ret), cmd.size() + ret.second.size());
+   }
+
+   return ret;
+}
+
+QueryCacheStats GitBase::getQueryCacheStats() const
+{
+   QMutexLocker lock(&queryCacheMutex);
+
+   const auto cache = queryCaches.value(mWorkingDirectory);
+
+   return cache ? cache->stats : QueryCacheStats();
+}
+
+QThreadPool *GitBase::threadPool()
+{
+   static QThreadPool pool;
+   static const auto configured = []() {
+      pool.setMaxThreadCount(qMax(MIN_GIT_THREADS, QThread::idealThreadCount()));
+      return true;
+   }();
+
+   Q_UNUSED(configured);
+
+   return &pool;
+}
+
 QString GitBase::getCurrentBranch() const
 {
    QLog_Trace("Git", "Executing getCurrentBranch");
 
-   const auto ret = run("git rev-parse --abbrev-ref HEAD");
+   const auto ret = runCached("git rev-parse --abbrev-ref HEAD");
 
    return ret.first ? ret.second.trimmed() : QString();
 }
@@ -26,9 +26,20 @@
 #include <GitExecResult.h>
 #include <RevisionsCache.h>
 
+#include <QFuture>
 #include <QObject>
+#include <QScopedPointer>
 #include <QSharedPointer>
 
+class GitObjectService;
+class QThreadPool;
+
+struct QueryCacheStats
+{
+   int hits = 0;
+   int misses = 0;
+};
+
 class GitBase : public QObject
 {
    Q_OBJECT
@@ -38,11 +49,27 @@ signals:
 
 public:
    explicit GitBase(const QString &workingDirectory, QObject *parent = nullptr);
-   QPair<bool, QString> run(const QString &cmd) const;
+   ~GitBase() override;
+   QPair<bool, QString> run(const QString &cmd, const QByteArray &input = QByteArray()) const;
+   // Same than run but in the pool of threads of git, so the caller is not blocked
+   QFuture<QPair<bool, QString>> runAsync(const QString &cmd, const QByteArray &input = QByteArray()) const;
+   // Same than run but the result is reused until HEAD, the index or the references change. Only for commands that
+   // don't modify the repository and whose output depends on nothing else.
+   QPair<bool, QString> runCached(const QString &cmd) const;
+   // Hits and misses of runCached for the working directory
+   QueryCacheStats getQueryCacheStats() const;
    QString getWorkingDir() const { return mWorkingDirectory; }
-   void setWorkingDir(const QString &workingDir) { mWorkingDirectory = workingDir; }
+   void setWorkingDir(const QString &workingDir);
    QString getCurrentBranch() const;
+   // Object and revision lookups that share a long-lived git process
+   GitObjectService *getObjectService() const;
+   // Pool of threads where the git commands run in the background (see runGitAsync in GitAsync.h)
+   static QThreadPool *threadPool();
 
 protected:
    QString mWorkingDirectory;
+   mutable QScopedPointer<GitObjectService> mObjectService;
+
+private:
+   QPair<bool, QString> runProcess(const QString &cmd, const QByteArray &input) const;
 };
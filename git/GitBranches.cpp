@@ -1,10 +1,42 @@
 #include "GitBranches.h"
 
+#include <CommitGraph.h>
+#include <CommitStore.h>
 #include <GitBase.h>
+#include <GitObjectService.h>
+#include <GraphAlgorithms.h>
 #include <QLogger.h>
 
+#include <QDir>
+#include <QHash>
+
 using namespace QLogger;
 
+namespace
+{
+// Fields separated by tabs: the track of the upstream has spaces, like in "ahead 1, behind 2"
+const QString BRANCHES_FORMAT("%(objectname)%09%(HEAD)%09%(refname)%09%(upstream)%09%(upstream:track,nobracket)");
+const QString LOCAL_PREFIX("refs/heads/");
+const QString REMOTE_PREFIX("refs/remotes/");
+
+void parseTrack(const QString &track, BranchInfo &branch)
+{
+   if (track == "gone")
+   {
+      branch.isUpstreamGone = true;
+      return;
+   }
+
+   for (const auto &part : track.split(", ", QString::SkipEmptyParts))
+   {
+      if (part.startsWith("ahead "))
+         branch.aheadOfUpstream = part.mid(6).toInt();
+      else if (part.startsWith("behind "))
+         branch.behindUpstream = part.mid(7).toInt();
+   }
+}
+}
+
 GitBranches::GitBranches(const QSharedPointer<GitBase> &gitBase)
    : mGitBase(gitBase)
 {
@@ -14,7 +46,175 @@ GitExecResult GitBranches::getBranches()
 {
    QLog_Debug("Git", "Executing getBranches");
 
-   return mGitBase->run(QString("git branch -a"));
+   return mGitBase->runCached(QString("git branch -a"));
+}
+
+bool GitBranches::getBranchesInfo(const QString &base, QVector<BranchInfo> &branches,
+                                  const CommitStore &loadedCommits)
+{
+   QLog_Debug("Git", QString("Executing getBranchesInfo: {%1}").arg(base));
+
+   const auto ret = mGitBase->runCached(
+       QString("git for-each-ref --format=%1 %2 %3").arg(BRANCHES_FORMAT, LOCAL_PREFIX, REMOTE_PREFIX));
+
+   if (!ret.first)
+      return false;
+
+   QString baseSha;
+
+   for (const auto &line : ret.second.split('\n', QString::SkipEmptyParts))
+   {
+      const auto fields = line.split('\t');
+
+      if (fields.count() != 5)
+         continue;
+
+      const auto &refName = fields.at(2);
+      BranchInfo branch;
+
+      if (refName.startsWith(REMOTE_PREFIX))
+      {
+         // The symbolic reference of the default branch of the remote
+         if (refName.endsWith("/HEAD"))
+            continue;
+
+         branch.name = refName.mid(REMOTE_PREFIX.size());
+         branch.isRemote = true;
+      }
+      else
+         branch.name = refName.mid(LOCAL_PREFIX.size());
+
+      branch.sha = fields.at(0);
+      branch.isCurrent = fields.at(1) == "*";
+      branch.hasUpstream = !fields.at(3).isEmpty();
+
+      if (branch.hasUpstream)
+         parseTrack(fields.at(4), branch);
+
+      if (branch.isRemote && branch.name == base)
+         baseSha = branch.sha;
+
+      branches.append(branch);
+   }
+
+   if (baseSha.isEmpty())
+      return true;
+
+   // The loaded history has the newest commits, the commit-graph has the ones that are not loaded yet. Only the
+   // distances that none of them know are asked to git.
+   const GraphAlgorithms loaded(loadedCommits);
+   const auto baseRow = loadedCommits.findRow(ObjectId::fromHex(baseSha));
+   CommitGraph graph;
+   auto isGraphTried = false;
+   auto basePos = -1;
+   auto fromLoaded = 0;
+   auto fromGraph = 0;
+   QVector<int> pending;
+
+   for (auto i = 0; i < branches.count(); ++i)
+   {
+      auto &branch = branches[i];
+
+      if (branch.isRemote)
+         continue;
+
+      const auto id = ObjectId::fromHex(branch.sha);
+      auto distance = qMakePair(-1, -1);
+
+      if (baseRow != -1)
+         distance = loaded.aheadBehind(loadedCommits.findRow(id), baseRow);
+
+      if (distance.first != -1)
+         ++fromLoaded;
+      else
+      {
+         // Only opened when the loaded commits are not enough
+         if (!isGraphTried)
+         {
+            const auto objectsInfo = mGitBase->runCached("git rev-parse --git-path objects/info");
+
+            if (objectsInfo.first
+                && graph.open(QDir(mGitBase->getWorkingDir()).absoluteFilePath(objectsInfo.second.trimmed())))
+               basePos = graph.find(ObjectId::fromHex(baseSha));
+
+            isGraphTried = true;
+         }
+
+         if (basePos != -1)
+            distance = graph.aheadBehind(graph.find(id), basePos);
+
+         if (distance.first != -1)
+            ++fromGraph;
+      }
+
+      if (distance.first == -1)
+         pending.append(i);
+
+      branch.aheadOfBase = distance.first;
+      branch.behindBase = distance.second;
+   }
+
+   if (!pending.isEmpty())
+      getDistancesFromGit(baseSha, pending, branches);
+
+   QLog_Debug("Git",
+              QString("Distances to {%1}: {%2} from the loaded commits, {%3} from the commit-graph and {%4} from git.")
+                  .arg(base)
+                  .arg(fromLoaded)
+                  .arg(fromGraph)
+                  .arg(pending.count()));
+
+   return true;
+}
+
+void GitBranches::getDistancesFromGit(const QString &baseSha, const QVector<int> &pending,
+                                      QVector<BranchInfo> &branches)
+{
+   // All the local branches are walked by one process (git 2.41 or newer)
+   const auto ret = mGitBase->runCached(
+       QString("git for-each-ref --format=%(refname)%09%(ahead-behind:%1) %2").arg(baseSha, LOCAL_PREFIX));
+
+   if (ret.first && !ret.second.startsWith("fatal:"))
+   {
+      QHash<QString, QPair<int, int>> distances;
+
+      for (const auto &line : ret.second.split('\n', QString::SkipEmptyParts))
+      {
+         const auto fields = line.split('\t');
+         const auto counts = fields.count() == 2 ? fields.at(1).split(' ') : QStringList();
+
+         if (counts.count() == 2)
+            distances.insert(fields.at(0).mid(LOCAL_PREFIX.size()),
+                             qMakePair(counts.at(0).toInt(), counts.at(1).toInt()));
+      }
+
+      for (const auto i : pending)
+      {
+         const auto distance = distances.value(branches.at(i).name, qMakePair(-1, -1));
+         branches[i].aheadOfBase = distance.first;
+         branches[i].behindBase = distance.second;
+      }
+
+      return;
+   }
+
+   // The older versions of git need one process for each branch
+   QLog_Debug("Git", QString("git doesn't know ahead-behind, the distances of {%1} branches are asked one by one.")
+                         .arg(pending.count()));
+
+   for (const auto i : pending)
+   {
+      auto &branch = branches[i];
+      const auto ret
+          = mGitBase->runCached(QString("git rev-list --left-right --count %1...%2").arg(baseSha, branch.sha));
+      const auto counts = ret.second.trimmed().split('\t');
+
+      if (ret.first && counts.count() == 2)
+      {
+         branch.aheadOfBase = counts.at(1).toInt();
+         branch.behindBase = counts.at(0).toInt();
+      }
+   }
 }
 
 GitExecResult GitBranches::getDistanceBetweenBranches(bool toMaster, const QString &right)
@@ -30,7 +230,7 @@ GitExecResult GitBranches::getDistanceBetweenBranches(bool toMaster, const QStri
                               .arg(toMaster ? QString("origin/master") : QString("origin/%3"))
                               .arg(right);
 
-   return mGitBase->run(gitCmd);
+   return mGitBase->runCached(gitCmd);
 }
 
 GitExecResult GitBranches::createBranchFromAnotherBranch(const QString &oldName, const QString &newName)
@@ -86,19 +286,15 @@ GitExecResult GitBranches::getBranchesOfCommit(const QString &sha)
 {
    QLog_Debug("Git", QString("Executing removeBranchesOfCommit: {%1}").arg(sha));
 
-   return mGitBase->run(QString("git branch --contains %1 --all").arg(sha));
+   return mGitBase->runCached(QString("git branch --contains %1 --all").arg(sha));
 }
 
-GitExecResult GitBranches::getLastCommitOfBranch(const QString &branch)
+void GitBranches::requestLastCommitOfBranch(const QString &branch, QObject *receiver,
+                                            std::function<void(const QString &sha)> callback)
 {
-   QLog_Debug("Git", QString("Executing getLastCommitOfBranch: {%1}").arg(branch));
-
-   auto ret = mGitBase->run(QString("git rev-parse %1").arg(branch));
-
-   if (ret.first)
-      ret.second.remove(ret.second.count() - 1, ret.second.count());
+   QLog_Debug("Git", QString("Executing requestLastCommitOfBranch: {%1}").arg(branch));
 
-   return ret;
+   mGitBase->getObjectService()->requestCommitSha(branch, receiver, std::move(callback));
 }
 
 GitExecResult GitBranches::pushUpstream(const QString &branchName)
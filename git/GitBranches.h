@@ -26,14 +26,40 @@
 #include <GitExecResult.h>
 
 #include <QSharedPointer>
+#include <QVector>
 
+#include <functional>
+
+class CommitStore;
 class GitBase;
+class QObject;
+
+struct BranchInfo
+{
+   // Name without refs/heads/ or refs/remotes/, like feature/foo or origin/feature/foo
+   QString name;
+   QString sha;
+   bool isRemote = false;
+   bool isCurrent = false;
+   bool hasUpstream = false;
+   bool isUpstreamGone = false;
+   int aheadOfUpstream = 0;
+   int behindUpstream = 0;
+   // Distance to the base branch of getBranchesInfo, -1 when it is unknown
+   int aheadOfBase = -1;
+   int behindBase = -1;
+};
 
 class GitBranches
 {
 public:
    GitBranches(const QSharedPointer<GitBase> &gitBase);
    GitExecResult getBranches();
+   // Local and remote branches with their distances to their upstream and to the base branch (only for the local
+   // ones). The list comes from one git process. The distances are computed with the loaded commits or the
+   // commit-graph when possible, git is asked only for the rest.
+   bool getBranchesInfo(const QString &base, QVector<BranchInfo> &branches,
+                        const CommitStore &loadedCommits = CommitStore());
    GitExecResult getDistanceBetweenBranches(bool toMaster, const QString &right);
    GitExecResult createBranchFromAnotherBranch(const QString &oldName, const QString &newName);
    GitExecResult createBranchAtCommit(const QString &commitSha, const QString &branchName);
@@ -43,11 +69,16 @@ public:
    GitExecResult removeLocalBranch(const QString &branchName);
    GitExecResult removeRemoteBranch(const QString &branchName);
    GitExecResult getBranchesOfCommit(const QString &sha);
-   GitExecResult getLastCommitOfBranch(const QString &branch);
+   // The callback gets the SHA of the last commit of the branch, or an empty SHA if it doesn't exist
+   void requestLastCommitOfBranch(const QString &branch, QObject *receiver,
+                                  std::function<void(const QString &sha)> callback);
    GitExecResult prune();
    QString getCurrentBranch() const;
    GitExecResult pushUpstream(const QString &branchName);
 
 private:
    QSharedPointer<GitBase> mGitBase;
+
+   // Distances to the base of the branches that neither the loaded commits nor the commit-graph know
+   void getDistancesFromGit(const QString &baseSha, const QVector<int> &pending, QVector<BranchInfo> &branches);
 };
@@ -0,0 +1,96 @@
+#include "GitCommitBodies.h"
+
+#include <GitBase.h>
+#include <GitObjectService.h>
+#include <RevisionsCache.h>
+
+#include <QLogger.h>
+
+#include <QPointer>
+#include <QTextCodec>
+
+using namespace QLogger;
+
+namespace
+{
+const int BODIES_BATCH_SIZE = 64;
+
+// Same text than %b: the message of the commit without the subject paragraph
+QString commitBody(const QByteArray &commit)
+{
+   const auto headersEnd = commit.indexOf("\n\n");
+   const auto subjectEnd = headersEnd == -1 ? -1 : commit.indexOf("\n\n", headersEnd + 2);
+
+   if (subjectEnd == -1)
+      return QString();
+
+   auto bodyStart = subjectEnd + 2;
+
+   while (bodyStart < commit.size() && commit.at(bodyStart) == '\n')
+      ++bodyStart;
+
+   const auto body = commit.mid(bodyStart);
+
+   // The messages are UTF-8 unless the commit says otherwise
+   const auto encodingStart = commit.left(headersEnd + 1).indexOf("\nencoding ");
+
+   if (encodingStart != -1)
+   {
+      const auto nameStart = encodingStart + 10;
+      const auto codec = QTextCodec::codecForName(commit.mid(nameStart, commit.indexOf('\n', nameStart) - nameStart));
+
+      if (codec)
+         return codec->toUnicode(body);
+   }
+
+   return QString::fromUtf8(body);
+}
+}
+
+GitCommitBodies::GitCommitBodies(const QSharedPointer<GitBase> &gitBase, const QSharedPointer<RevisionsCache> &cache)
+   : mGitBase(gitBase)
+   , mCache(cache)
+{
+}
+
+void GitCommitBodies::requestLongLog(const QString &sha, QObject *receiver, Callback callback)
+{
+   if (sha == CommitInfo::ZERO_SHA)
+   {
+      callback(mCache->getCommitInfo(sha).longLog());
+      return;
+   }
+
+   const auto id = ObjectId::fromHex(sha);
+   QString longLog;
+
+   if (id.isNull() || mCache->getLongLog(id, longLog))
+   {
+      callback(longLog);
+      return;
+   }
+
+   const auto ids = mCache->getMissingLongLogs(id, BODIES_BATCH_SIZE);
+
+   QLog_Debug("Git", QString("Loading the body of {%1} commits starting at {%2}.").arg(ids.count()).arg(sha));
+
+   const auto cache = mCache;
+   const QPointer<QObject> guard(receiver);
+
+   // All the commits are requested at once to the object service. The requested one is given to the callback as it is,
+   // since the cache doesn't keep the biggest bodies.
+   for (const auto &missingId : ids)
+   {
+      mGitBase->getObjectService()->requestContents(
+          missingId.toHex(), [cache, id, missingId, guard, callback](const GitObject &commit) {
+             const auto isCommit = commit.isValid() && commit.type == QLatin1String("commit");
+             const auto body = isCommit ? commitBody(commit.contents) : QString();
+
+             if (isCommit)
+                cache->insertLongLog(missingId, body);
+
+             if (missingId == id && guard)
+                callback(body);
+          });
+   }
+}
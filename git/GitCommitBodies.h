@@ -0,0 +1,51 @@
+#pragma once
+
+/****************************************************************************************
+ ** GitQlient is an application to manage and operate one or several Git repositories. With
+ ** GitQlient you will be able to add commits, branches and manage all the options Git provides.
+ ** Copyright (C) 2019  Francesc Martinez
+ **
+ ** LinkedIn: www.linkedin.com/in/cescmm/
+ ** Web: www.francescmm.com
+ **
+ ** This program is free software; you can redistribute it and/or
+ ** modify it under the terms of the GNU Lesser General Public
+ ** License as published by the Free Software Foundation; either
+ ** version 2 of the License, or (at your option) any later version.
+ **
+ ** This program is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ ** Lesser General Public License for more details.
+ **
+ ** You should have received a copy of the GNU Lesser General Public
+ ** License along with this library; if not, write to the Free Software
+ ** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ***************************************************************************************/
+
+#include <QSharedPointer>
+#include <QString>
+
+#include <functional>
+
+class GitBase;
+class QObject;
+class RevisionsCache;
+
+// The history is loaded without the body of the commits. This class brings them when they are shown: the requested one
+// together with the ones that follow it in the history, since they are likely the next ones to be shown.
+class GitCommitBodies
+{
+public:
+   using Callback = std::function<void(const QString &longLog)>;
+
+   explicit GitCommitBodies(const QSharedPointer<GitBase> &gitBase, const QSharedPointer<RevisionsCache> &cache);
+
+   // The callback gets the body right away if it's known. Otherwise it's read from the object service and the callback
+   // is called when it arrives, unless the receiver is destroyed before.
+   void requestLongLog(const QString &sha, QObject *receiver, Callback callback);
+
+private:
+   QSharedPointer<GitBase> mGitBase;
+   QSharedPointer<RevisionsCache> mCache;
+};
@@ -0,0 +1,160 @@
+#include "GitObjectService.h"
+
+#include <QPointer>
+#include <QProcess>
+
+#include <QLogger.h>
+
+using namespace QLogger;
+
+GitObjectService::GitObjectService(const QString &workingDir, QObject *parent)
+   : QObject(parent)
+   , mWorkingDir(workingDir)
+{
+   mContentsChannel.withContents = true;
+}
+
+GitObjectService::~GitObjectService()
+{
+   stop(mInfoChannel);
+   stop(mContentsChannel);
+}
+
+void GitObjectService::requestInfo(const QString &revision, Callback callback)
+{
+   request(mInfoChannel, revision, std::move(callback));
+}
+
+void GitObjectService::requestContents(const QString &revision, Callback callback)
+{
+   request(mContentsChannel, revision, std::move(callback));
+}
+
+void GitObjectService::requestCommitSha(const QString &revision, QObject *receiver,
+                                        std::function<void(const QString &sha)> callback)
+{
+   const QPointer<QObject> guard(receiver);
+
+   requestInfo(QString("%1^{commit}").arg(revision), [guard, callback](const GitObject &commit) {
+      if (guard)
+         callback(commit.isValid() ? commit.id.toHex() : QString());
+   });
+}
+
+void GitObjectService::request(Channel &channel, const QString &revision, Callback callback)
+{
+   // The protocol has one revision per line
+   if (revision.isEmpty() || revision.contains('\n') || !start(channel))
+   {
+      callback(GitObject());
+      return;
+   }
+
+   const auto line = revision.toUtf8();
+
+   channel.requests.enqueue({ line, std::move(callback) });
+   channel.process->write(line + '\n');
+}
+
+bool GitObjectService::start(Channel &channel)
+{
+   if (channel.process)
+      return true;
+
+   auto env = QProcess::systemEnvironment();
+   env << "GIT_TRACE=0"; // avoid choking on debug traces
+
+   const auto process = new QProcess(this);
+   process->setWorkingDirectory(mWorkingDir);
+   process->setEnvironment(env);
+   process->setStandardErrorFile(QProcess::nullDevice());
+
+   connect(process, &QProcess::readyReadStandardOutput, this, [this, &channel]() { onReadyRead(channel); });
+   connect(process, qOverload<int, QProcess::ExitStatus>(&QProcess::finished), this, [this, &channel]() {
+      QLog_Warning("Git", "The object service process finished unexpectedly.");
+      stop(channel);
+   });
+
+   process->start("git", { "cat-file", channel.withContents ? "--batch" : "--batch-check" });
+
+   if (!process->waitForStarted())
+   {
+      QLog_Warning("Git", QString("Unable to start the object service: %1").arg(process->errorString()));
+
+      delete process;
+      return false;
+   }
+
+   channel.process = process;
+
+   return true;
+}
+
+void GitObjectService::stop(Channel &channel)
+{
+   if (channel.process)
+   {
+      const auto process = channel.process;
+      channel.process = nullptr;
+
+      process->disconnect(this);
+      process->closeWriteChannel();
+
+      if (!process->waitForFinished(100))
+         process->kill();
+
+      process->deleteLater();
+   }
+
+   channel.output.clear();
+
+   // The requests that didn't get an answer get an invalid object
+   const auto requests = std::move(channel.requests);
+   channel.requests.clear();
+
+   for (const auto &request : requests)
+      request.callback(GitObject());
+}
+
+void GitObjectService::onReadyRead(Channel &channel)
+{
+   channel.output.append(channel.process->readAllStandardOutput());
+
+   while (!channel.requests.isEmpty())
+   {
+      const auto lineEnd = channel.output.indexOf('\n');
+
+      if (lineEnd == -1)
+         return;
+
+      // <id> <type> <size> or <revision> missing when the revision is not known
+      const auto line = channel.output.left(lineEnd);
+      const auto fields = line.split(' ');
+      auto consumed = lineEnd + 1;
+      GitObject object;
+
+      if (fields.count() == 3 && !line.endsWith(" missing") && !line.endsWith(" ambiguous"))
+      {
+         object.size = fields.at(2).toLongLong();
+
+         // The contents are followed by a new line
+         if (channel.withContents)
+         {
+            if (channel.output.size() < consumed + object.size + 1)
+               return;
+
+            object.contents = channel.output.mid(consumed, static_cast<int>(object.size));
+            consumed += static_cast<int>(object.size) + 1;
+         }
+
+         object.id = ObjectId::fromHex(fields.at(0).constData(), fields.at(0).size());
+         object.type = QString::fromLatin1(fields.at(1));
+      }
+
+      channel.output.remove(0, consumed);
+
+      // The callback can send new requests, so the answered one leaves the queue first
+      const auto request = channel.requests.dequeue();
+      request.callback(object);
+   }
+}
@@ -0,0 +1,94 @@
+#pragma once
+
+/****************************************************************************************
+ ** GitQlient is an application to manage and operate one or several Git repositories. With
+ ** GitQlient you will be able to add commits, branches and manage all the options Git provides.
+ ** Copyright (C) 2019  Francesc Martinez
+ **
+ ** LinkedIn: www.linkedin.com/in/cescmm/
+ ** Web: www.francescmm.com
+ **
+ ** This program is free software; you can redistribute it and/or
+ ** modify it under the terms of the GNU Lesser General Public
+ ** License as published by the Free Software Foundation; either
+ ** version 2 of the License, or (at your option) any later version.
+ **
+ ** This program is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ ** Lesser General Public License for more details.
+ **
+ ** You should have received a copy of the GNU Lesser General Public
+ ** License along with this library; if not, write to the Free Software
+ ** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ***************************************************************************************/
+
+#include <ObjectId.h>
+
+#include <QByteArray>
+#include <QObject>
+#include <QQueue>
+#include <QString>
+#include <QVector>
+
+#include <functional>
+
+class QProcess;
+
+struct GitObject
+{
+   ObjectId id;
+   QString type;
+   qint64 size = -1;
+   QByteArray contents;
+
+   bool isValid() const { return !id.isNull(); }
+};
+
+// Long-lived git cat-file processes that resolve revisions and read objects of the repository. The requests are written
+// to the standard input of the process as they come and the answers are given back in the same order, so many lookups
+// only cost one process instead of one process each.
+//
+// The info requests (id, type and size) go through git cat-file --batch-check and the contents requests through
+// git cat-file --batch. The processes are started with the first request and restarted if they die.
+class GitObjectService : public QObject
+{
+   Q_OBJECT
+
+public:
+   using Callback = std::function<void(const GitObject &object)>;
+
+   explicit GitObjectService(const QString &workingDir, QObject *parent = nullptr);
+   ~GitObjectService() override;
+
+   // The callback is called when the answer arrives. Unknown revisions get an invalid object.
+   void requestInfo(const QString &revision, Callback callback);
+   void requestContents(const QString &revision, Callback callback);
+   // Resolves the revision to the SHA of the commit it points to. The callback gets an empty SHA if there is no such
+   // commit, and it's not called if the receiver is destroyed before the answer arrives.
+   void requestCommitSha(const QString &revision, QObject *receiver, std::function<void(const QString &sha)> callback);
+
+private:
+   struct Request
+   {
+      QByteArray revision;
+      Callback callback;
+   };
+
+   struct Channel
+   {
+      QProcess *process = nullptr;
+      QQueue<Request> requests;
+      QByteArray output;
+      bool withContents = false;
+   };
+
+   QString mWorkingDir;
+   Channel mInfoChannel;
+   Channel mContentsChannel;
+
+   void request(Channel &channel, const QString &revision, Callback callback);
+   bool start(Channel &channel);
+   void stop(Channel &channel);
+   void onReadyRead(Channel &channel);
+};
@@ -3,14 +3,82 @@
 #include <GitBase.h>
 #include <RevisionsCache.h>
 #include <GitRequestorProcess.h>
+#include <CommitStoreFile.h>
+#include <CommitGraph.h>
 
 #include <QLogger.h>
 
+#include <QCryptographicHash>
 #include <QDir>
+#include <QHash>
+#include <QStandardPaths>
+#include <QtConcurrent>
+
+#include <algorithm>
+#include <cstring>
 
 using namespace QLogger;
 
-static const QString GIT_LOG_FORMAT = "%m%HX%P%n%cn<%ce>%n%an<%ae>%n%at%n%s%n%b ";
+static const QString GIT_LOG_FORMAT = "%m%HX%P%n%cn<%ce>%n%an<%ae>%n%at%n%s%n";
+static const int NOTIFY_INTERVAL_MS = 250;
+static const int PARALLEL_PARSING_CHUNK_SIZE = 1024 * 1024;
+static const int DETAILS_WINDOW_SIZE = 256;
+
+namespace
+{
+CommitInfo parseRevision(const QByteArray &record)
+{
+   return CommitInfo(record, -1);
+}
+
+QVector<CommitInfo> parseRevisions(const QVector<QByteArray> &records)
+{
+   QVector<CommitInfo> revisions;
+   revisions.reserve(records.count());
+
+   for (const auto &record : records)
+      revisions.append(parseRevision(record));
+
+   return revisions;
+}
+
+// The records point to the data, so it must outlive them
+QVector<QByteArray> splitRecords(const char *data, int size)
+{
+   QVector<QByteArray> records;
+   auto start = 0;
+
+   while (start < size)
+   {
+      const auto separator = static_cast<const char *>(memchr(data + start, '\000', static_cast<size_t>(size - start)));
+      const auto end = separator ? static_cast<int>(separator - data) : size;
+
+      if (end > start)
+         records.append(QByteArray::fromRawData(data + start, end - start));
+
+      start = end + 1;
+   }
+
+   return records;
+}
+
+QVector<CommitInfo> parseRecords(const char *data, int size)
+{
+   return parseRevisions(splitRecords(data, size));
+}
+
+// Builds the list of revisions that is passed through the standard input, since there can be too many references for
+// the command line
+QByteArray revisionsList(const QVector<ObjectId> &ids, const QByteArray &prefix = QByteArray())
+{
+   QByteArray list;
+
+   for (const auto &id : ids)
+      list.append(prefix).append(id.toHex().toLatin1()).append('\n');
+
+   return list;
+}
+}
 
 GitRepoLoader::GitRepoLoader(QSharedPointer<GitBase> gitBase, QSharedPointer<RevisionsCache> cache, QObject *parent)
    : QObject(parent)
@@ -74,23 +142,35 @@ void GitRepoLoader::loadReferences()
 {
    QLog_Debug("Git", "Loading references.");
 
-   const auto ret3 = mGitBase->run("git show-ref -d");
+   // HEAD goes first in the list, even when it's detached
+   const auto ret3 = mGitBase->run("git show-ref --head -d");
 
    if (ret3.first)
    {
-      auto ret = mGitBase->run("git rev-parse HEAD");
-
-      if (ret.first)
-         ret.second.remove(ret.second.count() - 1, ret.second.count());
-
-      QString prevRefSha;
-      const auto curBranchSHA = ret.second;
+      ObjectId prevRefSha;
+      ObjectId curBranchSHA;
       const auto referencesList = ret3.second.split('\n', QString::SkipEmptyParts);
 
+      mReferenceTips.clear();
+
       for (auto reference : referencesList)
       {
-         const auto revSha = reference.left(40);
-         const auto refName = reference.mid(41);
+         const auto separator = reference.indexOf(' ');
+         const auto revSha = ObjectId::fromHex(reference.left(separator));
+         const auto refName = reference.mid(separator + 1);
+
+         if (refName == QLatin1String("HEAD"))
+         {
+            curBranchSHA = revSha;
+
+            if (!curBranchSHA.isNull())
+               mReferenceTips.append(curBranchSHA);
+
+            continue;
+         }
+
+         if (mShowAll && !revSha.isNull())
+            mReferenceTips.append(revSha);
 
          // one Revision could have many tags
          auto cur = mRevCache->getReference(revSha);
@@ -98,16 +178,21 @@ void GitRepoLoader::loadReferences()
 
          mRevCache->insertReference(revSha, std::move(cur));
 
-         if (refName.startsWith("refs/tags/") && refName.endsWith("^{}") && !prevRefSha.isEmpty())
+         if (refName.startsWith("refs/tags/") && refName.endsWith("^{}") && !prevRefSha.isNull())
             mRevCache->removeReference(prevRefSha);
 
          prevRefSha = revSha;
       }
 
+      mHeadId = curBranchSHA;
+
       // mark current head (even when detached)
       auto cur = mRevCache->getReference(curBranchSHA);
       cur.type |= CUR_BRANCH;
       mRevCache->insertReference(curBranchSHA, std::move(cur));
+
+      std::sort(mReferenceTips.begin(), mReferenceTips.end());
+      mReferenceTips.erase(std::unique(mReferenceTips.begin(), mReferenceTips.end()), mReferenceTips.end());
    }
 }
 
@@ -115,45 +200,648 @@ void GitRepoLoader::requestRevisions()
 {
    QLog_Debug("Git", "Loading revisions.");
 
-   const auto baseCmd = QString("git log --date-order --no-color --log-size --parents --boundary -z --pretty=format:")
-                            .append(GIT_LOG_FORMAT)
-                            .append(mShowAll ? QString("--all") : mGitBase->getCurrentBranch());
+   mLoadedShowAll = mShowAll;
+   mPendingRevisions.clear();
+   mRevisionsCount = 0;
+   mNotifiedRevisions = 0;
+   mInsertTimeNs = 0;
+   mIsLogFinished = false;
+   mLoadTimer.start();
+
+   mRevCache->configure(0);
+
+   emit signalLoadingStarted();
+
+   QLog_Debug("Git", QString("Adding the WIP commit."));
+
+   updateWipRevision();
+
+   mHasMorePages = false;
+   mPageFrontier.clear();
+   mHasMissingDetails = false;
+   mIsLoadingDetails = false;
+   mQueuedDetailsRows = qMakePair(-1, -1);
+   mPendingDetails.clear();
+   ++mDetailsGeneration;
+   cancelCommitBodies();
+   mIsCacheOutdated = false;
+
+   // The known commits are not reused after a reload caused by them
+   const auto isLogLoadForced = mIsLogLoadForced;
+   mIsLogLoadForced = false;
+
+   if (!isLogLoadForced && loadCachedRevisions())
+      return;
+
+   // The paged history doesn't need the whole topology at once
+   if (!isLogLoadForced && mPageSize == 0 && loadGraphRevisions())
+      return;
+
+   requestLog();
+}
+
+void GitRepoLoader::loadNextPage()
+{
+   if (mLocked || !mHasMorePages)
+      return;
+
+   QLog_Debug("Git", QString("Loading the next {%1} revisions.").arg(mPageSize));
+
+   mLocked = true;
+
+   requestLog();
+}
+
+void GitRepoLoader::requestLog()
+{
+   auto baseCmd = QString("git log --date-order --no-color --log-size --parents -z --pretty=format:")
+                      .append(GIT_LOG_FORMAT);
+
+   // The pages are contiguous, so the boundary commits of one page would be repeated at the beginning of the next one
+   if (mPageSize > 0)
+      baseCmd.append(QString(" -n %1").arg(mPageSize));
+   else
+      baseCmd.append(" --boundary");
+
+   // The next page starts from the parents of the loaded commits that are not loaded. Since a commit is never shown
+   // before its children, none of the loaded commits can be reached from them again, so no offset is needed and the
+   // references that move between pages don't shift the history.
+   const auto isNextPage = !mPageFrontier.isEmpty();
+
+   if (isNextPage)
+      baseCmd.append(" --stdin");
+   else
+      baseCmd.append(' ').append(mShowAll ? QString("--all") : mGitBase->getCurrentBranch());
+
+   mPageStart = mRevisionsCount;
 
    const auto requestor = new GitRequestorProcess(mGitBase->getWorkingDir());
    connect(requestor, &GitRequestorProcess::procDataReady, this, &GitRepoLoader::processRevision);
+   connect(requestor, &GitRequestorProcess::procFinished, this, &GitRepoLoader::onRevisionsFinished);
    connect(this, &GitRepoLoader::cancelAllProcesses, requestor, &AGitProcess::onCancel);
 
+   if (isNextPage)
+      requestor->setStandardInput(revisionsList(mPageFrontier.values().toVector()));
+
+   mNotifyTimer.start();
+
    QString buf;
    requestor->run(baseCmd, buf);
 }
 
 void GitRepoLoader::processRevision(const QByteArray &ba)
 {
-   QLog_Debug("Git", "Processing revisions...");
+   mPendingRevisions.append(ba);
 
-   QByteArray auxBa = ba;
-   const auto commits = ba.split('\000');
-   const auto totalCommits = commits.count();
-   auto count = 1;
+   // The first commits are shown as soon as they arrive. After that, the data is gathered in bigger chunks so the
+   // parsing can be split between several threads.
+   const auto isFirstChunk = mNotifiedRevisions == 0 && mParsingChunks.isEmpty();
 
-   QLog_Debug("Git", QString("There are {%1} commits to process.").arg(totalCommits));
+   if (!isFirstChunk && mPendingRevisions.size() < PARALLEL_PARSING_CHUNK_SIZE)
+      return;
 
-   mRevCache->configure(totalCommits);
+   // Only the commits that are complete (NUL terminated) are processed. The tail waits for the next chunk.
+   const auto lastSeparator = mPendingRevisions.lastIndexOf('\000');
 
-   emit signalLoadingStarted();
+   if (lastSeparator != -1)
+   {
+      parseChunk(mPendingRevisions.left(lastSeparator + 1));
+      mPendingRevisions.remove(0, lastSeparator + 1);
+   }
+}
 
-   QLog_Debug("Git", QString("Adding the WIP commit."));
+void GitRepoLoader::parseChunk(const QByteArray &chunk)
+{
+   // Parsing the commits is independent for each one of them so it runs in the thread pool. The chunk keeps the data
+   // of the records alive until they are parsed.
+   const auto watcher = new QFutureWatcher<CommitInfo>(this);
+   connect(watcher, &QFutureWatcher<CommitInfo>::finished, this, &GitRepoLoader::insertParsedRevisions);
+
+   mParsingChunks.append({ chunk, watcher });
+
+   const auto &data = mParsingChunks.last().data;
+   watcher->setFuture(QtConcurrent::mapped(splitRecords(data.constData(), data.size()), parseRevision));
+}
+
+void GitRepoLoader::insertParsedRevisions()
+{
+   // The chunks can finish in any order, but the rows of the history follow the order of the log
+   while (!mParsingChunks.isEmpty() && mParsingChunks.first().watcher->isFinished())
+   {
+      const auto chunk = mParsingChunks.takeFirst();
+
+      insertRevisions(chunk.watcher->future().results());
+      chunk.watcher->deleteLater();
+   }
+
+   if (mNotifiedRevisions == 0 || mNotifyTimer.elapsed() >= NOTIFY_INTERVAL_MS)
+      notifyNewRevisions();
+
+   if (mIsLogFinished && mParsingChunks.isEmpty())
+      finishRevisions();
+}
+
+void GitRepoLoader::onRevisionsFinished(bool ok)
+{
+   mIsLogFinished = true;
+   mIsLogOk = ok;
+
+   // The last commit of the log is not followed by a separator
+   if (!mPendingRevisions.isEmpty())
+   {
+      parseChunk(mPendingRevisions);
+      mPendingRevisions.clear();
+   }
+
+   if (mParsingChunks.isEmpty())
+      finishRevisions();
+}
+
+void GitRepoLoader::finishRevisions()
+{
+   const auto ok = mIsLogOk;
+
+   mIsLogFinished = false;
+
+   QLog_Debug("Git",
+              QString("Loaded {%1} commits in {%2} ms. Inserting them took {%3} ms ({%4} ns per commit).")
+                  .arg(mRevisionsCount)
+                  .arg(mLoadTimer.elapsed())
+                  .arg(mInsertTimeNs / 1000000)
+                  .arg(mRevisionsCount > 0 ? mInsertTimeNs / mRevisionsCount : 0));
+
+   QLog_Debug("Git",
+              QString("The commits take {%1} KB in memory ({%2} KB with one object per commit).")
+                  .arg(mRevCache->memoryFootprint() / 1024)
+                  .arg(mRevCache->legacyMemoryFootprint() / 1024));
+
+   notifyNewRevisions();
+
+   // A page that is not full is the last one, as well as the one that leaves no parents to load. The rows of the next
+   // page are appended, so the graph goes on from the open lanes of this one.
+   mHasMorePages = ok && mPageSize > 0 && mRevisionsCount - mPageStart >= mPageSize && !mPageFrontier.isEmpty();
+
+   // A history that was cancelled, failed or is not loaded completely is not stored
+   if (ok && !mHasMorePages)
+      saveCachedRevisions();
+
+   mLocked = false;
+
+   emit signalLoadingFinished();
+}
+
+bool GitRepoLoader::refreshRepository()
+{
+   // Only a repository that is completely loaded can be extended
+   if (mLocked || mHasMorePages || mRevCache->count() <= 1 || mLoadedShowAll != mShowAll)
+      return false;
+
+   QLog_Info("Git", "Refreshing the repository...");
+
+   mLocked = true;
+
+   const auto knownHead = mHeadId;
+   const auto knownTips = mReferenceTips;
+
+   mRevCache->clearReferences();
+   loadReferences();
+
+   if (!isExtensionOf(knownTips))
+   {
+      mLocked = false;
+      return false;
+   }
 
    updateWipRevision();
+   loadNewRevisions(knownHead, knownTips);
 
-   for (const auto &commitInfo : commits)
+   return true;
+}
+
+bool GitRepoLoader::loadCachedRevisions()
+{
+   ObjectId cachedHead;
+   QVector<ObjectId> cachedTips;
+   CommitStore cachedCommits;
+
+   if (mReferenceTips.isEmpty() || !CommitStoreFile::read(cacheFilePath(), cachedHead, cachedTips, cachedCommits)
+       || !isExtensionOf(cachedTips))
    {
-      CommitInfo revision(commitInfo, count++);
+      return false;
+   }
 
-      if (revision.isValid())
-         mRevCache->insertCommitInfo(std::move(revision));
+   mRevCache->setCommits(std::move(cachedCommits));
+   mRevisionsCount = mRevCache->count() - 1;
+
+   QLog_Info("Git", QString("Loaded {%1} commits from the history cache.").arg(mRevisionsCount));
+
+   loadNewRevisions(cachedHead, cachedTips);
+
+   return true;
+}
+
+bool GitRepoLoader::loadGraphRevisions()
+{
+   const auto ret = mGitBase->run("git rev-parse --git-path objects/info");
+   CommitGraph graph;
+
+   if (!ret.first || !graph.open(QDir(mGitBase->getWorkingDir()).absoluteFilePath(ret.second.trimmed())))
+      return false;
+
+   // The references that are newer than the commit-graph are loaded afterwards with git log
+   QVector<ObjectId> graphTips;
+   QVector<int> tipPositions;
+
+   for (const auto &tip : mReferenceTips)
+   {
+      const auto pos = graph.find(tip);
+
+      if (pos != -1)
+      {
+         graphTips.append(tip);
+         tipPositions.append(pos);
+      }
+   }
+
+   if (tipPositions.isEmpty())
+      return false;
+
+   // Sorting the whole history takes a while in big repositories, so it's done in the thread pool. The files of the
+   // graph are shared, so the copy keeps them mapped.
+   const auto watcher = new QFutureWatcher<QVector<CommitInfo>>(this);
+   connect(watcher, &QFutureWatcher<QVector<CommitInfo>>::finished, this, [this, watcher, graphTips]() {
+      watcher->deleteLater();
+      onGraphRevisionsLoaded(watcher->result(), graphTips);
+   });
+
+   mLoadTimer.restart();
+
+   watcher->setFuture(QtConcurrent::run([graph, tipPositions]() {
+      const auto order = graph.dateOrder(tipPositions);
+      QVector<CommitInfo> revisions;
+      revisions.reserve(order.count());
+
+      for (const auto pos : order)
+      {
+         QVector<ObjectId> parents;
+
+         for (const auto parent : graph.parents(pos))
+            parents.append(graph.id(parent));
+
+         revisions.append(CommitInfo(graph.id(pos), parents, QDateTime::fromSecsSinceEpoch(graph.commitDate(pos)),
+                                     revisions.count() + 1));
+      }
+
+      return revisions;
+   }));
+
+   return true;
+}
+
+void GitRepoLoader::onGraphRevisionsLoaded(QVector<CommitInfo> revisions, const QVector<ObjectId> &graphTips)
+{
+   QLog_Info("Git",
+             QString("Loaded {%1} commits from the commit-graph in {%2} ms.")
+                 .arg(revisions.count())
+                 .arg(mLoadTimer.elapsed()));
+
+   insertRevisions(std::move(revisions));
+
+   // The graph is shown right away. The authors and the messages come afterwards, and the history is not stored until
+   // all of them are loaded.
+   mHasMissingDetails = true;
+   mIsCacheOutdated = true;
+   mDetailsCursor = 1;
+
+   notifyNewRevisions();
+   loadCommitDetails(1, DETAILS_WINDOW_SIZE);
+   loadNewRevisions(mHeadId, graphTips);
+}
+
+void GitRepoLoader::loadCommitDetails(int firstRow, int lastRow)
+{
+   if (!mHasMissingDetails)
+      return;
+
+   // Only one request runs at a time. The rows shown while it runs are requested after it, and only the last ones
+   // since the view could have been scrolled further away.
+   if (mIsLoadingDetails)
+   {
+      mQueuedDetailsRows = qMakePair(firstRow, lastRow);
+      return;
+   }
+
+   const auto &commits = mRevCache->commits();
+   const auto last = qMin(lastRow, qMin(firstRow + DETAILS_WINDOW_SIZE, commits.count()) - 1);
+   QVector<ObjectId> ids;
+
+   for (auto row = qMax(firstRow, 1); row <= last; ++row)
+   {
+      if (!commits.hasDetails(row))
+         ids.append(commits.id(row));
+   }
+
+   if (!ids.isEmpty())
+      requestCommitDetails(ids);
+   else
+      loadNextCommitDetails();
+}
+
+void GitRepoLoader::loadNextCommitDetails()
+{
+   // The rest of the history is loaded one window at a time, so the rows that are shown never wait for much
+   const auto &commits = mRevCache->commits();
+   QVector<ObjectId> ids;
+
+   for (; mDetailsCursor < commits.count() && ids.count() < DETAILS_WINDOW_SIZE; ++mDetailsCursor)
+   {
+      if (!commits.hasDetails(mDetailsCursor))
+         ids.append(commits.id(mDetailsCursor));
+   }
+
+   if (!ids.isEmpty())
+   {
+      requestCommitDetails(ids);
+      return;
+   }
+
+   mHasMissingDetails = false;
+
+   QLog_Info("Git", QString("Loaded the details of all the commits."));
+
+   // While the history is being loaded, it's stored when the load finishes
+   if (!mLocked)
+   {
+      mIsCacheOutdated = false;
+
+      saveCachedRevisions();
+   }
+}
+
+void GitRepoLoader::requestCommitDetails(const QVector<ObjectId> &ids)
+{
+   mIsLoadingDetails = true;
+
+   const auto generation = mDetailsGeneration;
+   const auto requestor = new GitRequestorProcess(mGitBase->getWorkingDir());
+   connect(requestor, &GitRequestorProcess::procDataReady, this,
+           [this, generation](const QByteArray &ba) { processCommitDetails(ba, generation); });
+   connect(requestor, &GitRequestorProcess::procFinished, this,
+           [this, generation](bool ok) { onCommitDetailsLoaded(ok, generation); });
+   connect(this, &GitRepoLoader::cancelAllProcesses, requestor, &AGitProcess::onCancel);
+
+   requestor->setStandardInput(revisionsList(ids));
+
+   // The commits are printed in the same order they are passed, that is the order of the rows
+   QString buf;
+   requestor->run(
+       QString("git log --no-walk=unsorted --no-color --log-size --parents --stdin -z --pretty=format:%1")
+           .arg(GIT_LOG_FORMAT),
+       buf);
+}
+
+void GitRepoLoader::processCommitDetails(const QByteArray &ba, int generation)
+{
+   // The details of a history that was reloaded are discarded
+   if (generation != mDetailsGeneration)
+      return;
+
+   mPendingDetails.append(ba);
+
+   const auto lastSeparator = mPendingDetails.lastIndexOf('\000');
+
+   if (lastSeparator != -1)
+   {
+      updateCommitDetails(mPendingDetails.constData(), lastSeparator + 1);
+      mPendingDetails.remove(0, lastSeparator + 1);
+   }
+}
+
+void GitRepoLoader::onCommitDetailsLoaded(bool ok, int generation)
+{
+   if (generation != mDetailsGeneration)
+      return;
+
+   if (!mPendingDetails.isEmpty())
+   {
+      updateCommitDetails(mPendingDetails.constData(), mPendingDetails.size());
+      mPendingDetails.clear();
+   }
+
+   mIsLoadingDetails = false;
+
+   const auto queuedRows = mQueuedDetailsRows;
+   mQueuedDetailsRows = qMakePair(-1, -1);
+
+   // The rows that are still missing are requested again when they are shown
+   if (!ok)
+      return;
+
+   if (queuedRows.first != -1)
+      loadCommitDetails(queuedRows.first, queuedRows.second);
+
+   if (!mIsLoadingDetails)
+      loadNextCommitDetails();
+}
+
+void GitRepoLoader::updateCommitDetails(const char *data, int size)
+{
+   auto firstRow = -1;
+   auto lastRow = -1;
+
+   for (const auto &revision : parseRecords(data, size))
+   {
+      const auto row = revision.isValid() ? mRevCache->updateCommitDetails(revision) : -1;
+
+      if (row != -1)
+      {
+         firstRow = firstRow == -1 ? row : qMin(firstRow, row);
+         lastRow = qMax(lastRow, row);
+      }
+   }
+
+   if (firstRow != -1)
+      emit signalRevisionsUpdated(firstRow, lastRow);
+}
+
+void GitRepoLoader::loadCommitBodies()
+{
+   cancelCommitBodies();
+
+   // The bodies are read from the same references as the history. Those of the commits not loaded are skipped.
+   const auto generation = mBodiesGeneration;
+   const auto requestor = new GitRequestorProcess(mGitBase->getWorkingDir());
+   mBodiesRequestor = requestor;
+
+   connect(requestor, &GitRequestorProcess::procDataReady, this, [this, generation](const QByteArray &ba) {
+      if (generation != mBodiesGeneration)
+         return;
+
+      mPendingBodies.append(ba);
+
+      // Only the records that are complete (NUL terminated) are indexed. The tail waits for the next chunk.
+      const auto lastSeparator = mPendingBodies.lastIndexOf('\000');
+
+      if (lastSeparator != -1)
+      {
+         mRevCache->indexBodies(mPendingBodies.left(lastSeparator));
+         mPendingBodies.remove(0, lastSeparator + 1);
+      }
+   });
+   connect(requestor, &GitRequestorProcess::procFinished, this, [this, generation](bool ok) {
+      if (generation != mBodiesGeneration)
+         return;
+
+      // The last record has no separator
+      if (ok)
+         mRevCache->indexBodies(mPendingBodies);
       else
-         break;
+         QLog_Warning("Git", "Unable to read the bodies of the commits for the search.");
+
+      mPendingBodies.clear();
+   });
+   connect(this, &GitRepoLoader::cancelAllProcesses, requestor, &QProcess::kill);
+
+   QString buf;
+   requestor->run(QString("git log --no-color -z --format=%H%n%b %1")
+                      .arg(mShowAll ? QString("--all") : mGitBase->getCurrentBranch()),
+                  buf);
+}
+
+void GitRepoLoader::cancelCommitBodies()
+{
+   ++mBodiesGeneration;
+   mPendingBodies.clear();
+
+   // The whole log would be read otherwise, keeping git busy for nothing
+   if (mBodiesRequestor)
+      mBodiesRequestor->kill();
+}
+
+bool GitRepoLoader::isExtensionOf(const QVector<ObjectId> &knownTips) const
+{
+   QVector<ObjectId> removedTips;
+   std::set_difference(knownTips.cbegin(), knownTips.cend(), mReferenceTips.cbegin(), mReferenceTips.cend(),
+                       std::back_inserter(removedTips));
+
+   // The known history can only be extended. If any of its commits is not reachable anymore (rebase, removed branch,
+   // etc.) the whole history has to be loaded again.
+   if (!removedTips.isEmpty())
+   {
+      const auto ret = mGitBase->run("git rev-list --stdin -n 1",
+                                     revisionsList(removedTips) + revisionsList(mReferenceTips, "^"));
+
+      if (!ret.first || !ret.second.trimmed().isEmpty())
+      {
+         QLog_Info("Git", "Some of the known commits are not reachable anymore.");
+         return false;
+      }
+   }
+
+   return true;
+}
+
+void GitRepoLoader::loadNewRevisions(const ObjectId &knownHead, const QVector<ObjectId> &knownTips)
+{
+   QVector<ObjectId> newTips;
+   std::set_difference(mReferenceTips.cbegin(), mReferenceTips.cend(), knownTips.cbegin(), knownTips.cend(),
+                       std::back_inserter(newTips));
+
+   mKnownRevisionsChanged = knownHead != mHeadId || knownTips != mReferenceTips;
+
+   // The WIP commit is the first one of the graph, so the lanes depend on which commit is its parent
+   if (knownHead != mHeadId)
+      mRevCache->rebuildLanes();
+
+   if (newTips.isEmpty())
+      onNewRevisionsLoaded(true);
+   else
+   {
+      QLog_Info("Git", QString("Loading the commits of {%1} new references.").arg(newTips.count()));
+
+      // The commits of the new tips that are not known are placed above their parents once they are all loaded
+      const auto requestor = new GitRequestorProcess(mGitBase->getWorkingDir());
+      connect(requestor, &GitRequestorProcess::procDataReady, this,
+              [this](const QByteArray &ba) { mPendingRevisions.append(ba); });
+      connect(requestor, &GitRequestorProcess::procFinished, this, &GitRepoLoader::onNewRevisionsLoaded);
+      connect(this, &GitRepoLoader::cancelAllProcesses, requestor, &AGitProcess::onCancel);
+
+      requestor->setStandardInput(revisionsList(newTips) + revisionsList(knownTips, "^"));
+
+      QString buf;
+      requestor->run(QString("git log --date-order --no-color --log-size --parents --stdin -z --pretty=format:%1")
+                         .arg(GIT_LOG_FORMAT),
+                     buf);
+   }
+}
+
+void GitRepoLoader::onNewRevisionsLoaded(bool ok)
+{
+   if (!ok)
+   {
+      mPendingRevisions.clear();
+      mLocked = false;
+
+      // A log that didn't finish can miss the parents of the commits it returned, so nothing of it is spliced
+      if (!mIsCanceling)
+      {
+         QLog_Warning("Git", "Unable to load the new commits. Loading the whole history.");
+
+         mIsLogLoadForced = true;
+
+         emit signalReloadRequired();
+      }
+
+      return;
+   }
+
+   QVector<CommitInfo> newRevisions;
+
+   for (auto &revision : parseRecords(mPendingRevisions.constData(), mPendingRevisions.size()))
+   {
+      if (revision.isValid())
+         newRevisions.append(std::move(revision));
+   }
+
+   mPendingRevisions.clear();
+
+   // The views that already show the history only get the new rows
+   const auto isShown = mNotifiedRevisions != 0;
+   const auto groups = placeNewRevisions(newRevisions);
+
+   // The groups go from the bottom up, so the rows where the next ones go don't move
+   for (auto iter = groups.crbegin(); iter != groups.crend(); ++iter)
+   {
+      const auto row = iter.key();
+      const auto &group = iter.value();
+
+      if (isShown)
+         emit signalRevisionsAboutToBeInserted(row, group.count());
+
+      mRevCache->insertCommits(row, group);
+      mRevisionsCount += group.count();
+
+      if (isShown)
+      {
+         mNotifiedRevisions = mRevisionsCount;
+
+         emit signalRevisionsInserted(row, group.count());
+      }
+   }
+
+   if (!newRevisions.isEmpty())
+      QLog_Info("Git", QString("Added {%1} new commits to the history.").arg(newRevisions.count()));
+
+   if (!isShown)
+      notifyNewRevisions();
+   else if (mKnownRevisionsChanged && newRevisions.isEmpty())
+      emit signalRevisionsInserted(1, 0);
+
+   if (mKnownRevisionsChanged || mIsCacheOutdated)
+   {
+      mIsCacheOutdated = false;
+
+      saveCachedRevisions();
    }
 
    mLocked = false;
@@ -161,6 +849,113 @@ void GitRepoLoader::processRevision(const QByteArray &ba)
    emit signalLoadingFinished();
 }
 
+QMap<int, QVector<CommitInfo>> GitRepoLoader::placeNewRevisions(const QVector<CommitInfo> &revisions) const
+{
+   // The log leaves out the ancestors of the known tips, so no known commit descends from a new one. The only rule is
+   // that every commit goes above its parents: each one is placed right above the highest one, known or new. The
+   // log lists the children before the parents, so it's walked backwards and the parents are already placed.
+   const auto &commits = mRevCache->commits();
+   QHash<ObjectId, int> newRows;
+   QVector<int> rows(revisions.count(), 1);
+
+   for (auto i = revisions.count() - 1; i >= 0; --i)
+   {
+      auto row = -1;
+
+      for (const auto &parent : revisions.at(i).parentIds())
+      {
+         const auto parentRow = newRows.contains(parent) ? newRows.value(parent) : commits.findRow(parent);
+
+         if (parentRow != -1)
+            row = row == -1 ? parentRow : qMin(row, parentRow);
+      }
+
+      // The commits without known parents (a new root) go on top, after the WIP commit
+      rows[i] = qMax(row, 1);
+      newRows.insert(revisions.at(i).id(), rows.at(i));
+   }
+
+   // The commits placed above the same row keep the order of the log
+   QMap<int, QVector<CommitInfo>> groups;
+
+   for (auto i = 0; i < revisions.count(); ++i)
+      groups[rows.at(i)].append(revisions.at(i));
+
+   return groups;
+}
+
+void GitRepoLoader::saveCachedRevisions()
+{
+   // A history without the texts of the commits is not stored
+   if (mHasMissingDetails)
+      return;
+
+   const auto path = cacheFilePath();
+   const auto head = mHeadId;
+   const auto tips = mReferenceTips;
+   const auto commits = mRevCache->commits(); // The columns are implicitly shared, so this copy is cheap
+
+   QtConcurrent::run([path, head, tips, commits]() { CommitStoreFile::write(path, head, tips, commits); });
+}
+
+QString GitRepoLoader::cacheFilePath() const
+{
+   // The history depends on the repository and on whether all the branches are shown or not
+   const auto key = QString("%1:%2").arg(mGitBase->getWorkingDir(), mShowAll ? QString("all") : QString("HEAD"));
+   const auto hash = QCryptographicHash::hash(key.toUtf8(), QCryptographicHash::Sha1).toHex();
+
+   return QString("%1/history/%2.cache")
+       .arg(QStandardPaths::writableLocation(QStandardPaths::CacheLocation), QString::fromLatin1(hash));
+}
+
+void GitRepoLoader::insertRevisions(QVector<CommitInfo> revisions)
+{
+   QElapsedTimer insertTimer;
+   insertTimer.start();
+
+   for (auto &revision : revisions)
+   {
+      if (!revision.isValid())
+         continue;
+
+      const auto id = revision.id();
+      const auto parents = revision.parentIds();
+
+      revision.orderIdx = mRevisionsCount + 1;
+
+      // The commits that are already known don't count for the page
+      if (!mRevCache->insertCommitInfo(std::move(revision)))
+         continue;
+
+      ++mRevisionsCount;
+
+      if (mPageSize > 0)
+      {
+         mPageFrontier.remove(id);
+
+         for (const auto &parent : parents)
+         {
+            if (mRevCache->commits().findRow(parent) == -1)
+               mPageFrontier.insert(parent);
+         }
+      }
+   }
+
+   mInsertTimeNs += insertTimer.nsecsElapsed();
+}
+
+void GitRepoLoader::notifyNewRevisions()
+{
+   mNotifyTimer.restart();
+
+   if (mRevisionsCount != mNotifiedRevisions)
+   {
+      mNotifiedRevisions = mRevisionsCount;
+
+      emit signalNewRevisions(mRevCache->count());
+   }
+}
+
 void GitRepoLoader::updateWipRevision()
 {
    QLog_Debug("Git", QString("Executing updateWipRevision."));
@@ -201,5 +996,8 @@ QVector<QString> GitRepoLoader::getUntrackedFiles() const
 
 void GitRepoLoader::cancelAll()
 {
+   // The processes finish while they are canceled, so their handlers can tell it from a failure
+   mIsCanceling = true;
    emit cancelAllProcesses(QPrivateSignal());
+   mIsCanceling = false;
 }
@@ -23,11 +23,21 @@
  ** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
  ***************************************************************************************/
 
+#include <CommitInfo.h>
+#include <ObjectId.h>
+
+#include <QFutureWatcher>
+#include <QMap>
 #include <QObject>
+#include <QPair>
+#include <QPointer>
+#include <QSet>
 #include <QSharedPointer>
 #include <QVector>
+#include <QElapsedTimer>
 
 class GitBase;
+class GitRequestorProcess;
 class RevisionsCache;
 
 class GitRepoLoader : public QObject
@@ -36,27 +46,103 @@ class GitRepoLoader : public QObject
 
 signals:
    void signalLoadingStarted();
+   void signalNewRevisions(int totalCommits);
+   // The rows are inserted in the cache between both signals
+   void signalRevisionsAboutToBeInserted(int firstRow, int count);
+   void signalRevisionsInserted(int firstRow, int count);
+   void signalRevisionsUpdated(int firstRow, int lastRow);
    void signalLoadingFinished();
+   // The known history can't be extended with the new commits, so it has to be cleared and loaded again
+   void signalReloadRequired();
    void cancelAllProcesses(QPrivateSignal);
 
 public:
    explicit GitRepoLoader(QSharedPointer<GitBase> gitBase, QSharedPointer<RevisionsCache> cache,
                           QObject *parent = nullptr);
    bool loadRepository();
+   bool refreshRepository();
    void updateWipRevision();
    void cancelAll();
    void setShowAll(bool showAll = true) { mShowAll = showAll; }
    bool showsAll() const { return mShowAll; }
+   // Number of commits loaded at once. With 0 the whole history is loaded.
+   void setPageSize(int pageSize) { mPageSize = pageSize; }
+   void loadNextPage();
+   // Loads the authors and the messages of the rows that are shown, when the history comes from the commit-graph
+   void loadCommitDetails(int firstRow, int lastRow);
+   // Streams the bodies of the commits into the search index. A previous stream is canceled.
+   void loadCommitBodies();
 
 private:
    bool mShowAll = true;
    bool mLocked = false;
+   bool mLoadedShowAll = true;
+   bool mHasMorePages = false;
+   int mPageSize = 0;
+   int mPageStart = 0;
+   // Parents of the loaded commits that are not loaded yet. The next page goes on from them.
+   QSet<ObjectId> mPageFrontier;
+   bool mHasMissingDetails = false;
+   bool mIsLoadingDetails = false;
+   int mDetailsGeneration = 0;
+   int mDetailsCursor = 1;
+   QPair<int, int> mQueuedDetailsRows { -1, -1 };
+   QByteArray mPendingDetails;
+   // The bodies of a previous load that arrive after a new one started are dropped
+   QPointer<GitRequestorProcess> mBodiesRequestor;
+   int mBodiesGeneration = 0;
+   QByteArray mPendingBodies;
+   bool mKnownRevisionsChanged = false;
+   bool mIsCacheOutdated = false;
+   bool mIsLogLoadForced = false;
+   bool mIsCanceling = false;
    QSharedPointer<GitBase> mGitBase;
    QSharedPointer<RevisionsCache> mRevCache;
+   ObjectId mHeadId;
+   QVector<ObjectId> mReferenceTips;
+   QByteArray mPendingRevisions;
+   int mRevisionsCount = 0;
+   int mNotifiedRevisions = 0;
+   qint64 mInsertTimeNs = 0;
+   QElapsedTimer mNotifyTimer;
+   QElapsedTimer mLoadTimer;
+
+   // Chunks of the log that are parsed in the thread pool, in the order they arrived
+   struct ParsingChunk
+   {
+      QByteArray data;
+      QFutureWatcher<CommitInfo> *watcher = nullptr;
+   };
+   QVector<ParsingChunk> mParsingChunks;
+   bool mIsLogFinished = false;
+   bool mIsLogOk = false;
 
    bool configureRepoDirectory();
    void loadReferences();
    void requestRevisions();
+   void requestLog();
    void processRevision(const QByteArray &ba);
+   void parseChunk(const QByteArray &chunk);
+   void insertParsedRevisions();
+   void onRevisionsFinished(bool ok);
+   void finishRevisions();
+   bool loadCachedRevisions();
+   bool loadGraphRevisions();
+   void onGraphRevisionsLoaded(QVector<CommitInfo> revisions, const QVector<ObjectId> &graphTips);
+   void loadNextCommitDetails();
+   void requestCommitDetails(const QVector<ObjectId> &ids);
+   void processCommitDetails(const QByteArray &ba, int generation);
+   void onCommitDetailsLoaded(bool ok, int generation);
+   void updateCommitDetails(const char *data, int size);
+   void cancelCommitBodies();
+   bool isExtensionOf(const QVector<ObjectId> &knownTips) const;
+   void loadNewRevisions(const ObjectId &knownHead, const QVector<ObjectId> &knownTips);
+   void onNewRevisionsLoaded(bool ok);
+   // Groups the new commits by the row they are inserted at
+   QMap<int, QVector<CommitInfo>> placeNewRevisions(const QVector<CommitInfo> &revisions) const;
+   void saveCachedRevisions();
+   QString cacheFilePath() const;
+   void insertRevisions(QVector<CommitInfo> revisions);
+   void notifyNewRevisions();
    QVector<QString> getUntrackedFiles() const;
 };
@@ -1,6 +1,5 @@
 #include "GitRequestorProcess.h"
 
-#include <QTemporaryFile>
 GitRequestorProcess::GitRequestorProcess(const QString &workingDir)
    : AGitProcess(workingDir)
 {
@@ -8,34 +7,20 @@ GitRequestorProcess::GitRequestorProcess(const QString &workingDir)
 
 bool GitRequestorProcess::run(const QString &command, QString &)
 {
-   auto ret = false;
-
-   // Create temporary file
-   mTempFile = new QTemporaryFile(this);
-
-   if (mTempFile->open()) // to read the file name
-   {
-
-      setStandardOutputFile(mTempFile->fileName());
-      mTempFile->close();
-
-      ret = execute(command);
-   }
-
-   return ret;
+   // The output is not redirected to a file so it can be processed as it arrives through procDataReady
+   return execute(command);
 }
 
-void GitRequestorProcess::onFinished(int, QProcess::ExitStatus)
+void GitRequestorProcess::onFinished(int exitCode, QProcess::ExitStatus exitStatus)
 {
-   bool ok = mTempFile && (mTempFile->isOpen() || (mTempFile->exists() && mTempFile->open()));
+   AGitProcess::onFinished(exitCode, exitStatus);
+
+   const auto ba = readAllStandardOutput();
 
-   if (ok)
-   {
-      const auto ba = mTempFile->readAll();
+   if (ba.size() != 0 && !mCanceling)
+      emit procDataReady(ba);
 
-      if (ba.size() != 0 && !mCanceling)
-         emit procDataReady(ba);
-   }
+   emit procFinished(!mRealError);
 
    deleteLater();
 }
@@ -25,19 +25,17 @@
 
 #include <AGitProcess.h>
 
-class QTemporaryFile;
-
 class GitRequestorProcess : public AGitProcess
 {
    Q_OBJECT
 
+signals:
+   void procFinished(bool ok);
+
 public:
    explicit GitRequestorProcess(const QString &workingDir);
    bool run(const QString &command, QString &output) override;
 
 private:
    void onFinished(int, QProcess::ExitStatus exitStatus) override;
-
-private:
-   QTemporaryFile *mTempFile = nullptr;
 };
@@ -1,6 +1,7 @@
 #include "GitTags.h"
 
 #include <GitBase.h>
+#include <GitObjectService.h>
 #include <QLogger.h>
 
 using namespace QLogger;
@@ -14,7 +15,7 @@ QVector<QString> GitTags::getTags() const
 {
    QLog_Debug("Git", QString("Executing getTags"));
 
-   const auto ret = mGitBase->run("git tag");
+   const auto ret = mGitBase->runCached("git tag");
 
    QVector<QString> tags;
 
@@ -79,12 +80,10 @@ GitExecResult GitTags::pushTag(const QString &tagName)
    return mGitBase->run(QString("git push origin %1").arg(tagName));
 }
 
-GitExecResult GitTags::getTagCommit(const QString &tagName)
+void GitTags::requestTagCommit(const QString &tagName, QObject *receiver,
+                               std::function<void(const QString &sha)> callback)
 {
-   QLog_Debug("Git", QString("Executing getTagCommit: {%1}").arg(tagName));
+   QLog_Debug("Git", QString("Executing requestTagCommit: {%1}").arg(tagName));
 
-   const auto ret = mGitBase->run(QString("git rev-list -n 1 %1").arg(tagName));
-   const auto output = ret.second.trimmed();
-
-   return qMakePair(ret.first, output);
+   mGitBase->getObjectService()->requestCommitSha(tagName, receiver, std::move(callback));
 }
@@ -29,7 +29,10 @@
 #include <QString>
 #include <QSharedPointer>
 
+#include <functional>
+
 class GitBase;
+class QObject;
 
 class GitTags
 {
@@ -41,7 +44,8 @@ public:
    GitExecResult addTag(const QString &tagName, const QString &tagMessage, const QString &sha);
    GitExecResult removeTag(const QString &tagName, bool remote);
    GitExecResult pushTag(const QString &tagName);
-   GitExecResult getTagCommit(const QString &tagName);
+   // The callback gets the SHA of the commit of the tag, or an empty SHA if it doesn't exist
+   void requestTagCommit(const QString &tagName, QObject *receiver, std::function<void(const QString &sha)> callback);
 
 private:
    QSharedPointer<GitBase> mGitBase;
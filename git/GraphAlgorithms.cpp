@@ -0,0 +1,128 @@
+#include "GraphAlgorithms.h"
+
+#include <GraphWalk.h>
+#include <lanes.h>
+
+namespace
+{
+// Cap of the nearest ancestors kept per commit, so an octopus of filtered branches doesn't blow up the sets
+const int MAX_SUBSET_PARENTS = 8;
+
+// The rows are in topological order, so the lowest row goes first. The parents that are not loaded can't be walked.
+struct StoreWalk
+{
+   const CommitStore &commits;
+
+   int key(int row) const { return -row; }
+
+   bool parents(int row, QVector<int> &parents) const
+   {
+      auto allLoaded = true;
+
+      for (const auto parentId : commits.parentIds(row))
+      {
+         const auto parentRow = commits.idRow(parentId);
+
+         if (parentRow != -1)
+            parents.append(parentRow);
+         else
+            allLoaded = false;
+      }
+
+      return allLoaded;
+   }
+};
+}
+
+GraphAlgorithms::GraphAlgorithms(const CommitStore &commits)
+   : mCommits(commits)
+{
+}
+
+QPair<int, int> GraphAlgorithms::aheadBehind(int leftRow, int rightRow) const
+{
+   const auto rows = mCommits.count();
+
+   if (leftRow < 0 || leftRow >= rows || rightRow < 0 || rightRow >= rows)
+      return qMakePair(-1, -1);
+
+   return GraphWalk::aheadBehind(StoreWalk { mCommits }, leftRow, rightRow);
+}
+
+QVector<QVector<LaneType>> GraphAlgorithms::subsetLanes(const QVector<int> &rows) const
+{
+   const auto count = mCommits.count();
+   QVector<bool> isInSubset(count, false);
+
+   for (auto row : rows)
+      isInSubset[row] = true;
+
+   // Bottom-up, the parents are always visited before their children. For each commit, nearest has the closest
+   // commits of the subset that it reaches: itself if it's in the subset.
+   QVector<QVector<int>> nearest(count);
+   QVector<QVector<int>> subsetParents(rows.count());
+   auto subsetIdx = rows.count() - 1;
+
+   for (auto row = count - 1; row >= 0; --row)
+   {
+      QVector<int> reached;
+
+      if (mCommits.rowId(row) != -1)
+      {
+         for (auto parentId : mCommits.parentIds(row))
+         {
+            const auto parentRow = mCommits.idRow(parentId);
+
+            if (parentRow == -1)
+               continue;
+
+            // The first parent goes first so the lanes follow it as in the full graph
+            if (reached.isEmpty())
+               reached = nearest.at(parentRow);
+            else
+            {
+               for (auto ancestor : nearest.at(parentRow))
+               {
+                  if (!reached.contains(ancestor))
+                     reached.append(ancestor);
+               }
+            }
+         }
+      }
+
+      if (reached.count() > MAX_SUBSET_PARENTS)
+         reached.resize(MAX_SUBSET_PARENTS);
+
+      if (isInSubset.at(row))
+      {
+         subsetParents[subsetIdx--] = reached;
+         nearest[row] = { row };
+      }
+      else
+         nearest[row] = reached;
+   }
+
+   Lanes lanes;
+   QVector<QVector<LaneType>> subsetLanes;
+   subsetLanes.reserve(rows.count());
+
+   for (auto i = 0; i < rows.count(); ++i)
+   {
+      const auto id = mCommits.rowId(rows.at(i));
+
+      if (id == -1)
+      {
+         subsetLanes.append(QVector<LaneType>());
+         continue;
+      }
+
+      QVector<int> parentIds;
+
+      for (auto parentRow : subsetParents.at(i))
+         parentIds.append(mCommits.rowId(parentRow));
+
+      subsetLanes.append(lanes.update(id, parentIds, mCommits.isBoundary(rows.at(i))));
+   }
+
+   return subsetLanes;
+}
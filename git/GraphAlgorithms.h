@@ -0,0 +1,52 @@
+#pragma once
+
+/****************************************************************************************
+ ** GitQlient is an application to manage and operate one or several Git repositories. With
+ ** GitQlient you will be able to add commits, branches and manage all the options Git provides.
+ ** Copyright (C) 2019  Francesc Martinez
+ **
+ ** LinkedIn: www.linkedin.com/in/cescmm/
+ ** Web: www.francescmm.com
+ **
+ ** This program is free software; you can redistribute it and/or
+ ** modify it under the terms of the GNU Lesser General Public
+ ** License as published by the Free Software Foundation; either
+ ** version 2 of the License, or (at your option) any later version.
+ **
+ ** This program is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ ** Lesser General Public License for more details.
+ **
+ ** You should have received a copy of the GNU Lesser General Public
+ ** License along with this library; if not, write to the Free Software
+ ** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ***************************************************************************************/
+
+#include <CommitStore.h>
+
+#include <QPair>
+
+// Graph algorithms over the commits loaded in a CommitStore. The commits are identified by their row, and the rows are
+// in topological order: a commit always goes before its parents. That order plays the role of the generation numbers,
+// so visiting the lowest row first means that a commit is visited after all the loaded commits that can reach it.
+//
+// The walks only go through the loaded commits. When an answer depends on a commit that is not loaded (a boundary
+// commit, a commit of the next page, etc.) the methods say it is unknown and the caller has to ask git.
+class GraphAlgorithms
+{
+public:
+   // The store is implicitly shared, so it can be a copy taken in the UI thread and used in another one
+   explicit GraphAlgorithms(const CommitStore &commits);
+
+   // Returns the number of commits reachable from the left row but not from the right one, and the other way around,
+   // as git rev-list --left-right --count right...left. Both are -1 if it is unknown.
+   QPair<int, int> aheadBehind(int leftRow, int rightRow) const;
+
+   // Returns the lanes of the graph made only of the given rows, sorted. The parents of each commit are its nearest
+   // ancestors among those rows, so a filtered history keeps its branches and merges.
+   QVector<QVector<LaneType>> subsetLanes(const QVector<int> &rows) const;
+
+private:
+   CommitStore mCommits;
+};
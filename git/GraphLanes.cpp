@@ -0,0 +1,77 @@
+#include "GraphLanes.h"
+
+#include <CommitStore.h>
+
+GraphLanes::GraphLanes()
+{
+   reset();
+}
+
+void GraphLanes::reset(const Lanes &initial)
+{
+   mCheckpoints = { initial };
+   mBlocks.clear();
+}
+
+void GraphLanes::invalidate(int firstRow)
+{
+   // The checkpoint of a block only depends on the rows above it
+   const auto firstBlock = qMax(firstRow, 0) / CHECKPOINT_ROWS;
+
+   if (mCheckpoints.count() > firstBlock + 1)
+      mCheckpoints.resize(firstBlock + 1);
+
+   for (const auto block : mBlocks.keys())
+   {
+      if (block >= firstBlock)
+         mBlocks.remove(block);
+   }
+}
+
+void GraphLanes::lanes(const CommitStore &commits, int row, QVector<LaneType> &lanes)
+{
+   if (row < 0 || row >= commits.count())
+   {
+      lanes.resize(0);
+      return;
+   }
+
+   const auto block = row / CHECKPOINT_ROWS;
+
+   // The blocks above the row are full, so replaying each one of them leaves the checkpoint of the next one
+   while (mCheckpoints.count() <= block)
+      replay(commits, mCheckpoints.count() - 1);
+
+   // The last block grows while the history is loaded, so it's replayed again when it doesn't have the row yet
+   auto packed = mBlocks.object(block);
+   const auto blockRow = row - block * CHECKPOINT_ROWS;
+
+   if (!packed || blockRow >= packed->count())
+      packed = replay(commits, block);
+
+   packed->decode(blockRow, lanes);
+}
+
+PackedLanes *GraphLanes::replay(const CommitStore &commits, int block)
+{
+   auto lanes = mCheckpoints.at(block);
+   const auto first = block * CHECKPOINT_ROWS;
+   const auto last = qMin(first + CHECKPOINT_ROWS, commits.count());
+   const auto packed = new PackedLanes();
+   packed->reserve(last - first);
+
+   for (auto row = first; row < last; ++row)
+   {
+      const auto id = commits.rowId(row);
+
+      packed->append(id == -1 ? QVector<LaneType>()
+                              : lanes.update(id, commits.parentIds(row), commits.isBoundary(row)));
+   }
+
+   if (last - first == CHECKPOINT_ROWS && mCheckpoints.count() == block + 1)
+      mCheckpoints.append(lanes);
+
+   mBlocks.insert(block, packed);
+
+   return packed;
+}
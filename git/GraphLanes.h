@@ -0,0 +1,61 @@
+#pragma once
+
+/****************************************************************************************
+ ** GitQlient is an application to manage and operate one or several Git repositories. With
+ ** GitQlient you will be able to add commits, branches and manage all the options Git provides.
+ ** Copyright (C) 2019  Francesc Martinez
+ **
+ ** LinkedIn: www.linkedin.com/in/cescmm/
+ ** Web: www.francescmm.com
+ **
+ ** This program is free software; you can redistribute it and/or
+ ** modify it under the terms of the GNU Lesser General Public
+ ** License as published by the Free Software Foundation; either
+ ** version 2 of the License, or (at your option) any later version.
+ **
+ ** This program is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ ** Lesser General Public License for more details.
+ **
+ ** You should have received a copy of the GNU Lesser General Public
+ ** License along with this library; if not, write to the Free Software
+ ** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ***************************************************************************************/
+
+#include <PackedLanes.h>
+#include <lanes.h>
+
+#include <QCache>
+#include <QVector>
+
+class CommitStore;
+
+// The lanes of the graph are not kept for every row. The state of the lanes engine is saved every CHECKPOINT_ROWS rows
+// the first time the graph goes through them, and the lanes of a row are computed when they are painted by replaying
+// the commits from the checkpoint above it. The last blocks replayed are kept packed, so the rows of a screen only
+// replay their block once.
+class GraphLanes
+{
+public:
+   static const int CHECKPOINT_ROWS = 4096;
+
+   GraphLanes();
+
+   // Drops the checkpoints and the replayed blocks. The lanes start again from the given state, the one after the WIP
+   // commit.
+   void reset(const Lanes &initial = Lanes());
+   // Drops what depends on the rows from the given one on. The checkpoints above it are kept.
+   void invalidate(int firstRow);
+   // Computes the lanes of the row into the vector, reusing its memory
+   void lanes(const CommitStore &commits, int row, QVector<LaneType> &lanes);
+
+private:
+   static const int MAX_CACHED_BLOCKS = 8;
+
+   // State of the lanes before the first row of each block
+   QVector<Lanes> mCheckpoints;
+   QCache<int, PackedLanes> mBlocks { MAX_CACHED_BLOCKS };
+
+   PackedLanes *replay(const CommitStore &commits, int block);
+};
@@ -0,0 +1,116 @@
+#pragma once
+
+/****************************************************************************************
+ ** GitQlient is an application to manage and operate one or several Git repositories. With
+ ** GitQlient you will be able to add commits, branches and manage all the options Git provides.
+ ** Copyright (C) 2019  Francesc Martinez
+ **
+ ** LinkedIn: www.linkedin.com/in/cescmm/
+ ** Web: www.francescmm.com
+ **
+ ** This program is free software; you can redistribute it and/or
+ ** modify it under the terms of the GNU Lesser General Public
+ ** License as published by the Free Software Foundation; either
+ ** version 2 of the License, or (at your option) any later version.
+ **
+ ** This program is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ ** Lesser General Public License for more details.
+ **
+ ** You should have received a copy of the GNU Lesser General Public
+ ** License along with this library; if not, write to the Free Software
+ ** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ***************************************************************************************/
+
+#include <QHash>
+#include <QPair>
+#include <QVector>
+
+#include <queue>
+#include <utility>
+
+namespace GraphWalk
+{
+// Returns the number of commits reachable from left but not from right, and the other way around, as git rev-list
+// --left-right --count right...left. Both are -1 if it is unknown.
+//
+// The commits with the highest key are visited first, so a commit is counted once all the commits that can reach it are
+// done. The walk ends when all the commits in the queue are reachable from both sides, since so are their parents. The
+// graph gives:
+// - key(node): a commit always has a higher key than its parents, like its generation number.
+// - parents(node, parents): fills the parents that can be walked. It returns false if any of them is missing, which is
+//   only fine when the commit is reachable from both sides.
+template<typename Graph>
+QPair<int, int> aheadBehind(const Graph &graph, int left, int right)
+{
+   const quint8 REACHED_FROM_LEFT = 0x1;
+   const quint8 REACHED_FROM_RIGHT = 0x2;
+   const quint8 REACHED_FROM_BOTH = REACHED_FROM_LEFT | REACHED_FROM_RIGHT;
+   const quint8 QUEUED = 0x4;
+
+   using Key = decltype(graph.key(left));
+
+   QHash<int, quint8> flags;
+   std::priority_queue<std::pair<Key, int>> queue;
+   auto pendingOneSide = 0;
+
+   const auto reach = [&](int node, quint8 side) {
+      auto &nodeFlags = flags[node];
+      const auto previous = nodeFlags;
+
+      if ((previous & side) == side)
+         return;
+
+      nodeFlags |= side | QUEUED;
+
+      if (!(previous & QUEUED))
+      {
+         queue.emplace(graph.key(node), node);
+
+         if ((nodeFlags & REACHED_FROM_BOTH) != REACHED_FROM_BOTH)
+            ++pendingOneSide;
+      }
+      else if ((nodeFlags & REACHED_FROM_BOTH) == REACHED_FROM_BOTH)
+         --pendingOneSide;
+   };
+
+   reach(left, REACHED_FROM_LEFT);
+   reach(right, REACHED_FROM_RIGHT);
+
+   auto ahead = 0;
+   auto behind = 0;
+   QVector<int> parents;
+
+   while (pendingOneSide > 0 && !queue.empty())
+   {
+      const auto node = queue.top().second;
+      queue.pop();
+
+      auto &nodeFlags = flags[node];
+      nodeFlags &= ~QUEUED;
+
+      const auto side = static_cast<quint8>(nodeFlags & REACHED_FROM_BOTH);
+
+      if (side != REACHED_FROM_BOTH)
+      {
+         --pendingOneSide;
+
+         if (side == REACHED_FROM_LEFT)
+            ++ahead;
+         else
+            ++behind;
+      }
+
+      parents.clear();
+
+      if (!graph.parents(node, parents) && side != REACHED_FROM_BOTH)
+         return qMakePair(-1, -1);
+
+      for (const auto parent : parents)
+         reach(parent, side);
+   }
+
+   return qMakePair(ahead, behind);
+}
+}
@@ -0,0 +1,98 @@
+#include "ObjectId.h"
+
+namespace
+{
+int hexValue(ushort c)
+{
+   if (c >= '0' && c <= '9')
+      return c - '0';
+
+   if (c >= 'a' && c <= 'f')
+      return c - 'a' + 10;
+
+   if (c >= 'A' && c <= 'F')
+      return c - 'A' + 10;
+
+   return -1;
+}
+
+template<typename Char>
+bool parseHex(const Char *hex, int size, uchar *bytes)
+{
+   if (size != 2 * ObjectId::SHA1_SIZE && size != 2 * ObjectId::SHA256_SIZE)
+      return false;
+
+   for (auto i = 0; i < size; i += 2)
+   {
+      const auto high = hexValue(static_cast<ushort>(hex[i]));
+      const auto low = hexValue(static_cast<ushort>(hex[i + 1]));
+
+      if (high == -1 || low == -1)
+         return false;
+
+      bytes[i / 2] = static_cast<uchar>((high << 4) | low);
+   }
+
+   return true;
+}
+}
+
+ObjectId ObjectId::fromHex(const QString &hex)
+{
+   ObjectId id;
+
+   if (parseHex(reinterpret_cast<const ushort *>(hex.constData()), hex.size(), id.mBytes.data()))
+      id.mSize = static_cast<uchar>(hex.size() / 2);
+   else
+      id = ObjectId();
+
+   return id;
+}
+
+ObjectId ObjectId::fromHex(const char *hex, int size)
+{
+   ObjectId id;
+
+   if (parseHex(reinterpret_cast<const uchar *>(hex), size, id.mBytes.data()))
+      id.mSize = static_cast<uchar>(size / 2);
+   else
+      id = ObjectId();
+
+   return id;
+}
+
+ObjectId ObjectId::fromBytes(const uchar *bytes, int size)
+{
+   ObjectId id;
+
+   if (size == SHA1_SIZE || size == SHA256_SIZE)
+   {
+      memcpy(id.mBytes.data(), bytes, static_cast<size_t>(size));
+      id.mSize = static_cast<uchar>(size);
+   }
+
+   return id;
+}
+
+QString ObjectId::toHex() const
+{
+   static const char digits[] = "0123456789abcdef";
+
+   QString hex(2 * mSize, Qt::Uninitialized);
+   auto out = hex.data();
+
+   for (auto i = 0; i < mSize; ++i)
+   {
+      *out++ = QLatin1Char(digits[mBytes[static_cast<size_t>(i)] >> 4]);
+      *out++ = QLatin1Char(digits[mBytes[static_cast<size_t>(i)] & 0xf]);
+   }
+
+   return hex;
+}
+
+bool ObjectId::operator<(const ObjectId &other) const
+{
+   const auto cmp = memcmp(mBytes.data(), other.mBytes.data(), static_cast<size_t>(qMin(mSize, other.mSize)));
+
+   return cmp != 0 ? cmp < 0 : mSize < other.mSize;
+}
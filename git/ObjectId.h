@@ -0,0 +1,74 @@
+#pragma once
+
+/****************************************************************************************
+ ** GitQlient is an application to manage and operate one or several Git repositories. With
+ ** GitQlient you will be able to add commits, branches and manage all the options Git provides.
+ ** Copyright (C) 2019  Francesc Martinez
+ **
+ ** LinkedIn: www.linkedin.com/in/cescmm/
+ ** Web: www.francescmm.com
+ **
+ ** This program is free software; you can redistribute it and/or
+ ** modify it under the terms of the GNU Lesser General Public
+ ** License as published by the Free Software Foundation; either
+ ** version 2 of the License, or (at your option) any later version.
+ **
+ ** This program is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ ** Lesser General Public License for more details.
+ **
+ ** You should have received a copy of the GNU Lesser General Public
+ ** License along with this library; if not, write to the Free Software
+ ** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ***************************************************************************************/
+
+#include <QString>
+#include <QtGlobal>
+
+#include <array>
+#include <cstring>
+
+// Binary representation of the id of a Git object: 20 bytes for SHA-1 and 32 bytes for SHA-256 repositories. The
+// hexadecimal form is only built when it has to be shown to the user or passed to a git process.
+class ObjectId
+{
+public:
+   static const int SHA1_SIZE = 20;
+   static const int SHA256_SIZE = 32;
+
+   ObjectId() = default;
+
+   static ObjectId fromHex(const QString &hex);
+   static ObjectId fromHex(const char *hex, int size);
+   static ObjectId fromBytes(const uchar *bytes, int size);
+
+   bool isNull() const { return mSize == 0; }
+   int size() const { return mSize; }
+   const uchar *data() const { return mBytes.data(); }
+   QString toHex() const;
+
+   bool operator==(const ObjectId &other) const
+   {
+      return mSize == other.mSize && memcmp(mBytes.data(), other.mBytes.data(), mSize) == 0;
+   }
+   bool operator!=(const ObjectId &other) const { return !(*this == other); }
+   bool operator<(const ObjectId &other) const;
+
+private:
+   std::array<uchar, SHA256_SIZE> mBytes {};
+   uchar mSize = 0;
+};
+
+Q_DECLARE_TYPEINFO(ObjectId, Q_MOVABLE_TYPE);
+
+// The bytes of an object id are already uniformly distributed, so the first ones are a good enough hash
+inline uint qHash(const ObjectId &id, uint seed = 0)
+{
+   uint hash = 0;
+
+   if (!id.isNull())
+      memcpy(&hash, id.data(), sizeof(hash));
+
+   return hash ^ seed;
+}
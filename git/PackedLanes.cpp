@@ -0,0 +1,122 @@
+#include "PackedLanes.h"
+
+#include <lanes.h>
+
+namespace
+{
+const int TYPE_BITS = 5;
+const quint32 RUN_CODE = (1u << TYPE_BITS) - 1;
+const int RUN_LENGTH_BITS = 8;
+// A run takes the bits of 3.6 lanes, so only runs of 4 or more lanes are worth it
+const int MIN_RUN = 4;
+const int MAX_RUN = MIN_RUN + (1 << RUN_LENGTH_BITS) - 1;
+const qint64 WORD_BITS = 32;
+
+static_assert(static_cast<quint32>(LaneType::LANE_TYPES_NUM) <= RUN_CODE, "The lane types don't fit in the codes");
+}
+
+void PackedLanes::clear()
+{
+   mWords.clear();
+   mOffsets = { 0 };
+}
+
+void PackedLanes::reserve(int rows)
+{
+   mOffsets.reserve(rows + 1);
+}
+
+void PackedLanes::append(const QVector<LaneType> &lanes)
+{
+   auto position = mOffsets.last();
+   const auto total = lanes.count();
+
+   for (auto i = 0; i < total;)
+   {
+      const auto type = static_cast<quint32>(lanes.at(i));
+      auto next = i + 1;
+
+      while (next < total && lanes.at(next) == lanes.at(i))
+         ++next;
+
+      auto run = next - i;
+
+      while (run >= MIN_RUN)
+      {
+         const auto length = qMin(run, MAX_RUN);
+
+         appendBits(position, RUN_CODE, TYPE_BITS);
+         appendBits(position, type, TYPE_BITS);
+         appendBits(position, static_cast<quint32>(length - MIN_RUN), RUN_LENGTH_BITS);
+
+         run -= length;
+      }
+
+      for (; run > 0; --run)
+         appendBits(position, type, TYPE_BITS);
+
+      i = next;
+   }
+
+   mOffsets.append(position);
+}
+
+QVector<LaneType> PackedLanes::lanes(int row) const
+{
+   QVector<LaneType> lanes;
+   decode(row, lanes);
+
+   return lanes;
+}
+
+void PackedLanes::decode(int row, QVector<LaneType> &lanes) const
+{
+   lanes.resize(0);
+
+   const auto end = mOffsets.at(row + 1);
+
+   for (auto position = mOffsets.at(row); position < end;)
+   {
+      const auto code = readBits(position, TYPE_BITS);
+      position += TYPE_BITS;
+
+      if (code == RUN_CODE)
+      {
+         const auto type = static_cast<LaneType>(readBits(position, TYPE_BITS));
+         const auto length = static_cast<int>(readBits(position + TYPE_BITS, RUN_LENGTH_BITS)) + MIN_RUN;
+         position += TYPE_BITS + RUN_LENGTH_BITS;
+
+         lanes.insert(lanes.end(), length, type);
+      }
+      else
+         lanes.append(static_cast<LaneType>(code));
+   }
+}
+
+void PackedLanes::appendBits(qint64 &position, quint32 value, int bits)
+{
+   const auto word = static_cast<int>(position / WORD_BITS);
+   const auto shift = static_cast<int>(position % WORD_BITS);
+
+   if (word == mWords.count())
+      mWords.append(0);
+
+   mWords[word] |= value << shift;
+
+   if (shift + bits > WORD_BITS)
+      mWords.append(value >> (WORD_BITS - shift));
+
+   position += bits;
+}
+
+quint32 PackedLanes::readBits(qint64 position, int bits) const
+{
+   const auto word = static_cast<int>(position / WORD_BITS);
+   const auto shift = static_cast<int>(position % WORD_BITS);
+   quint64 chunk = mWords.at(word);
+
+   if (shift + bits > WORD_BITS)
+      chunk |= static_cast<quint64>(mWords.at(word + 1)) << WORD_BITS;
+
+   return static_cast<quint32>(chunk >> shift) & ((1u << bits) - 1);
+}
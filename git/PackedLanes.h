@@ -0,0 +1,55 @@
+#pragma once
+
+/****************************************************************************************
+ ** GitQlient is an application to manage and operate one or several Git repositories. With
+ ** GitQlient you will be able to add commits, branches and manage all the options Git provides.
+ ** Copyright (C) 2019  Francesc Martinez
+ **
+ ** LinkedIn: www.linkedin.com/in/cescmm/
+ ** Web: www.francescmm.com
+ **
+ ** This program is free software; you can redistribute it and/or
+ ** modify it under the terms of the GNU Lesser General Public
+ ** License as published by the Free Software Foundation; either
+ ** version 2 of the License, or (at your option) any later version.
+ **
+ ** This program is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ ** Lesser General Public License for more details.
+ **
+ ** You should have received a copy of the GNU Lesser General Public
+ ** License along with this library; if not, write to the Free Software
+ ** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ***************************************************************************************/
+
+#include <QVector>
+
+enum class LaneType;
+
+// Lanes of all the rows of the graph packed in a single bit stream. Each lane takes 5 bits, and a run of the same lane
+// (like the NOT_ACTIVE lanes that go by most of the commits of a wide graph) takes a run code, the lane and its length.
+// Each row keeps the bit where its lanes start, so a row is decoded without touching the others.
+class PackedLanes
+{
+public:
+   PackedLanes() = default;
+
+   void clear();
+   void reserve(int rows);
+   int count() const { return mOffsets.count() - 1; }
+   void append(const QVector<LaneType> &lanes);
+
+   QVector<LaneType> lanes(int row) const;
+   // Decodes the lanes of the row into the vector. Its memory is reused, so decoding the rows of a screen one after
+   // another doesn't allocate.
+   void decode(int row, QVector<LaneType> &lanes) const;
+
+private:
+   QVector<quint32> mWords;
+   // Bit where the lanes of each row start, plus the end of the stream
+   QVector<qint64> mOffsets { 0 };
+
+   void appendBits(qint64 &position, quint32 value, int bits);
+   quint32 readBits(qint64 position, int bits) const;
+};
@@ -0,0 +1,189 @@
+#include "ReachabilityIndex.h"
+
+#include <CommitStore.h>
+
+#include <QSet>
+
+void ReachabilityIndex::build(const CommitStore &commits, const QVector<QPair<QString, int>> &tips)
+{
+   clear();
+
+   mCommits = &commits;
+
+   QHash<int, QVector<int>> branchesByRow;
+
+   for (const auto &tip : tips)
+   {
+      if (tip.second >= 0 && tip.second < commits.count())
+      {
+         branchesByRow[tip.second].append(mBranches.count());
+         mBranches.append(tip.first);
+      }
+   }
+
+   // The set 0 is the empty one
+   intern(QBitArray(mBranches.count()));
+
+   mRowSets.fill(0, commits.count());
+
+   for (auto row = 0; row < commits.count(); ++row)
+   {
+      auto set = mRowSets.at(row);
+      const auto tipBranches = branchesByRow.value(row);
+
+      if (!tipBranches.isEmpty())
+      {
+         auto bits = mSets.at(set);
+
+         for (const auto branch : tipBranches)
+            bits.setBit(branch);
+
+         set = intern(bits);
+         mRowSets[row] = set;
+      }
+
+      if (set == 0)
+         continue;
+
+      for (const auto parentId : commits.parentIds(row))
+      {
+         const auto parentRow = commits.idRow(parentId);
+
+         if (parentRow != -1)
+            mRowSets[parentRow] = unite(mRowSets.at(parentRow), set);
+      }
+   }
+
+   mUnions.clear();
+
+   // The parents go after their children, so they get their generation first. The parents that are not loaded count
+   // as roots.
+   mGenerations.fill(1, commits.count());
+
+   for (auto row = commits.count() - 1; row >= 0; --row)
+   {
+      for (const auto parentId : commits.parentIds(row))
+      {
+         const auto parentRow = commits.idRow(parentId);
+
+         if (parentRow != -1)
+            mGenerations[row] = qMax(mGenerations.at(row), mGenerations.at(parentRow) + 1);
+      }
+   }
+}
+
+void ReachabilityIndex::clear()
+{
+   mCommits = nullptr;
+   mBranches.clear();
+   mRowSets.clear();
+   mGenerations.clear();
+   mSets.clear();
+   mSetIds.clear();
+   mUnions.clear();
+}
+
+QStringList ReachabilityIndex::branchesContaining(int row) const
+{
+   const auto set = setOfRow(row);
+   QStringList branches;
+
+   for (auto i = 0; i < set.size(); ++i)
+   {
+      if (set.testBit(i))
+         branches.append(mBranches.at(i));
+   }
+
+   return branches;
+}
+
+bool ReachabilityIndex::isAncestor(int ancestorRow, int row) const
+{
+   if (!mCommits || row < 0 || row >= mRowSets.count() || ancestorRow < 0 || ancestorRow >= mRowSets.count())
+      return false;
+
+   // The ancestors go after their descendants
+   if (ancestorRow == row)
+      return true;
+
+   if (ancestorRow < row)
+      return false;
+
+   // Every branch that reaches the commit reaches its ancestors too
+   const auto set = setOfRow(row);
+
+   if ((set & setOfRow(ancestorRow)) != set)
+      return false;
+
+   // A commit can only reach the ones with a lower generation, so the walk doesn't go below the generation of the
+   // ancestor nor through the commits after it. The first parent is followed first, since it's usually the way.
+   const auto ancestorGeneration = mGenerations.at(ancestorRow);
+
+   if (mGenerations.at(row) <= ancestorGeneration)
+      return false;
+
+   QVector<int> pending { row };
+   QSet<int> visited { row };
+
+   while (!pending.isEmpty())
+   {
+      const auto current = pending.takeLast();
+      const auto parentIds = mCommits->parentIds(current);
+
+      for (auto i = parentIds.count() - 1; i >= 0; --i)
+      {
+         const auto parentRow = mCommits->idRow(parentIds.at(i));
+
+         if (parentRow == ancestorRow)
+            return true;
+
+         if (parentRow != -1 && parentRow < ancestorRow && mGenerations.at(parentRow) > ancestorGeneration
+             && !visited.contains(parentRow))
+         {
+            visited.insert(parentRow);
+            pending.append(parentRow);
+         }
+      }
+   }
+
+   return false;
+}
+
+int ReachabilityIndex::intern(const QBitArray &set)
+{
+   const auto known = mSetIds.constFind(set);
+
+   if (known != mSetIds.cend())
+      return known.value();
+
+   mSets.append(set);
+   mSetIds.insert(set, mSets.count() - 1);
+
+   return mSets.count() - 1;
+}
+
+int ReachabilityIndex::unite(int first, int second)
+{
+   if (first == second || second == 0)
+      return first;
+
+   if (first == 0)
+      return second;
+
+   const auto key = qMakePair(qMin(first, second), qMax(first, second));
+   const auto known = mUnions.constFind(key);
+
+   if (known != mUnions.cend())
+      return known.value();
+
+   const auto set = intern(mSets.at(first) | mSets.at(second));
+
+   mUnions.insert(key, set);
+
+   return set;
+}
+
+QBitArray ReachabilityIndex::setOfRow(int row) const
+{
+   return row >= 0 && row < mRowSets.count() ? mSets.at(mRowSets.at(row)) : QBitArray(mBranches.count());
+}
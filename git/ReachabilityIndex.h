@@ -0,0 +1,66 @@
+#pragma once
+
+/****************************************************************************************
+ ** GitQlient is an application to manage and operate one or several Git repositories. With
+ ** GitQlient you will be able to add commits, branches and manage all the options Git provides.
+ ** Copyright (C) 2019  Francesc Martinez
+ **
+ ** LinkedIn: www.linkedin.com/in/cescmm/
+ ** Web: www.francescmm.com
+ **
+ ** This program is free software; you can redistribute it and/or
+ ** modify it under the terms of the GNU Lesser General Public
+ ** License as published by the Free Software Foundation; either
+ ** version 2 of the License, or (at your option) any later version.
+ **
+ ** This program is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ ** Lesser General Public License for more details.
+ **
+ ** You should have received a copy of the GNU Lesser General Public
+ ** License along with this library; if not, write to the Free Software
+ ** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ***************************************************************************************/
+
+#include <QBitArray>
+#include <QHash>
+#include <QPair>
+#include <QStringList>
+#include <QVector>
+
+class CommitStore;
+
+// Index of the branches that reach each commit of a CommitStore. Every row gets the set of branches whose tip is the
+// commit or one of its descendants. The history has few different sets (they only change at the tips and at the
+// merges), so the rows keep the index of a set shared with the others.
+//
+// The rows are in topological order, so the index is built in one pass that gives the set of each commit to its
+// parents. Another pass from the bottom gives each commit its generation number (the length of the longest path to a
+// root), that bounds the walks between two commits.
+class ReachabilityIndex
+{
+public:
+   ReachabilityIndex() = default;
+
+   // The tips are the branch names with the row of their commit
+   void build(const CommitStore &commits, const QVector<QPair<QString, int>> &tips);
+   void clear();
+
+   QStringList branchesContaining(int row) const;
+   // Whether the first row is the second one or one of its ancestors
+   bool isAncestor(int ancestorRow, int row) const;
+
+private:
+   const CommitStore *mCommits = nullptr;
+   QStringList mBranches;
+   QVector<int> mRowSets;
+   QVector<int> mGenerations;
+   QVector<QBitArray> mSets;
+   QHash<QBitArray, int> mSetIds;
+   QHash<QPair<int, int>, int> mUnions;
+
+   int intern(const QBitArray &set);
+   int unite(int first, int second);
+   QBitArray setOfRow(int row) const;
+};
@@ -2,7 +2,7 @@
 
 #include <ReferenceType.h>
 
-void Reference::configure(const QString &refName, bool isCurrentBranch, const QString &prevRefSha)
+void Reference::configure(const QString &refName, bool isCurrentBranch, const ObjectId &prevRefSha)
 {
    if (refName.startsWith("refs/tags/"))
    {
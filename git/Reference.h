@@ -1,6 +1,7 @@
 #pragma once
 
 #include <ReferenceType.h>
+#include <ObjectId.h>
 
 #include <QString>
 #include <QStringList>
@@ -9,7 +10,7 @@ struct Reference
 {
    Reference() = default;
 
-   void configure(const QString &refName, bool isCurrentBranch, const QString &prevRefSha);
+   void configure(const QString &refName, bool isCurrentBranch, const ObjectId &prevRefSha);
    bool isValid() const { return type != 0; }
 
    uint type = 0;
@@ -17,7 +18,7 @@ struct Reference
    QStringList remoteBranches;
    QStringList tags;
    QStringList refs;
-   QString tagObj; // TODO support more then one obj
+   ObjectId tagObj; // TODO support more then one obj
    QString tagMsg;
    QString stgitPatch;
 };
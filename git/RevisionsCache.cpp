@@ -1,32 +1,35 @@
 #include "RevisionsCache.h"
 
+#include <QFutureWatcher>
+#include <QtConcurrentRun>
+
 #include <QLogger.h>
 
+#include <algorithm>
+
 using namespace QLogger;
 
-RevisionsCache::RevisionsCache(QObject *parent)
-   : QObject(parent)
+namespace
 {
+// The bodies of the commits are only kept for the last ones that were shown. The cost of each body is its length.
+const int MAX_LONG_LOGS_SIZE = 1024 * 1024;
 }
 
-RevisionsCache::~RevisionsCache()
+RevisionsCache::RevisionsCache(QObject *parent)
+   : QObject(parent)
+   , mLongLogs(MAX_LONG_LOGS_SIZE)
 {
-   for (auto commit : mCommits)
-      delete commit;
-
-   mCommits.clear();
-   mCommitsMap.clear();
 }
 
 void RevisionsCache::configure(int numElementsToStore)
 {
    QLog_Debug("Git", QString("Configuring the cache for {%1} elements.").arg(numElementsToStore));
 
-   if (mCommits.isEmpty())
+   if (mCommits.count() == 0)
    {
       // We reserve 1 extra slots for the ZERO_SHA (aka WIP commit)
-      mCommits.resize(numElementsToStore + 1);
-      mCommitsMap.reserve(numElementsToStore + 1);
+      mCommits.reserve(numElementsToStore + 1);
+      mCommits.append(CommitInfo());
    }
 
    mCacheLocked = false;
@@ -34,93 +37,237 @@ void RevisionsCache::configure(int numElementsToStore)
 
 CommitInfo RevisionsCache::getCommitInfoByRow(int row) const
 {
-   const auto commit = row >= 0 && row < mCommits.count() ? mCommits.at(row) : nullptr;
+   return row == 0 ? mWipCommit : mCommits.commit(row);
+}
+
+ObjectId RevisionsCache::getCommitIdByRow(int row) const
+{
+   return row == 0 ? mWipCommit.id() : mCommits.id(row);
+}
+
+void RevisionsCache::getLanes(int row, QVector<LaneType> &lanes) const
+{
+   if (row == 0)
+      lanes = mWipCommit.lanes;
+   else
+      mLanes.lanes(mCommits, row, lanes);
+}
+
+QVector<int> RevisionsCache::findCommits(const QString &text) const
+{
+   QVector<int> rows;
+
+   if (mSearchIndexState == SearchIndexState::Ready)
+   {
+      for (const auto id : mSearchIndex.find(text))
+      {
+         const auto row = mCommits.idRow(id);
+
+         if (row != -1)
+            rows.append(row);
+      }
+
+      std::sort(rows.begin(), rows.end());
+   }
+   else
+   {
+      // Same matching than the index, but going through all the commits. Only the bodies that are cached are known.
+      const auto words = CommitSearchIndex::words(text);
+
+      for (auto row = 0; !words.isEmpty() && row < mCommits.count(); ++row)
+      {
+         auto commitText = searchText(mCommits, row).toLower();
+
+         if (const auto longLog = mLongLogs.object(mCommits.id(row)))
+            commitText.append(' ').append(longLog->toLower());
+
+         if (std::all_of(words.cbegin(), words.cend(), [&commitText](const QString &word) {
+                return commitText.contains(word);
+             }))
+            rows.append(row);
+      }
+   }
+
+   return rows;
+}
+
+bool RevisionsCache::buildSearchIndex()
+{
+   if (mSearchIndexState != SearchIndexState::NotBuilt)
+      return false;
+
+   mSearchIndexState = SearchIndexState::Building;
+
+   const auto generation = mSearchIndexGeneration;
+   const auto commits = mCommits; // The columns are implicitly shared, so this copy is cheap
+   const auto watcher = new QFutureWatcher<CommitSearchIndex>(this);
+
+   connect(watcher, &QFutureWatcherBase::finished, this, [this, watcher, generation]() {
+      watcher->deleteLater();
+
+      if (generation != mSearchIndexGeneration)
+         return;
+
+      mSearchIndex = watcher->result();
+
+      for (const auto &pending : qAsConst(mPendingSearchTexts))
+         mSearchIndex.addCommit(pending.first, pending.second);
+
+      mPendingSearchTexts.clear();
+      mSearchIndexState = SearchIndexState::Ready;
+
+      QLog_Debug("Git", QString("The search index is ready."));
+   });
+
+   watcher->setFuture(QtConcurrent::run([commits]() {
+      CommitSearchIndex index;
+
+      for (auto row = 0; row < commits.count(); ++row)
+      {
+         if (commits.rowId(row) != -1)
+            index.addCommit(commits.rowId(row), searchText(commits, row));
+      }
+
+      return index;
+   }));
+
+   return true;
+}
+
+void RevisionsCache::indexBodies(const QByteArray &records)
+{
+   auto start = 0;
+
+   while (start < records.size())
+   {
+      auto end = records.indexOf('\000', start);
+
+      if (end == -1)
+         end = records.size();
+
+      // <SHA>\n<body>
+      const auto newLine = records.indexOf('\n', start);
+
+      if (newLine != -1 && newLine < end - 1)
+      {
+         const auto row = mCommits.findRow(ObjectId::fromHex(records.constData() + start, newLine - start));
+
+         if (row != -1 && mCommits.rowId(row) != -1)
+            indexText(mCommits.rowId(row), QString::fromUtf8(records.constData() + newLine + 1, end - newLine - 1));
+      }
+
+      start = end + 1;
+   }
+}
+
+void RevisionsCache::indexCommit(int row)
+{
+   if (mCommits.rowId(row) != -1)
+      indexText(mCommits.rowId(row), searchText(mCommits, row));
+}
 
-   return commit ? *commit : CommitInfo();
+void RevisionsCache::indexText(int id, const QString &text)
+{
+   if (mSearchIndexState == SearchIndexState::Ready)
+      mSearchIndex.addCommit(id, text);
+   else if (mSearchIndexState == SearchIndexState::Building)
+      mPendingSearchTexts.append(qMakePair(id, text));
 }
 
-CommitInfo RevisionsCache::getCommitInfoByField(CommitInfo::Field field, const QString &text, int startingPoint)
+void RevisionsCache::resetSearchIndex()
 {
-   auto commitIter = searchCommit(field, text, startingPoint);
+   ++mSearchIndexGeneration;
+   mSearchIndex.clear();
+   mPendingSearchTexts.clear();
+   mSearchIndexState = SearchIndexState::NotBuilt;
+}
 
-   if (commitIter == mCommits.constEnd() && startingPoint > 0)
-      commitIter = searchCommit(field, text);
+QString RevisionsCache::searchText(const CommitStore &commits, int row)
+{
+   // Only the names are searched, the e-mails would add the same words to most of the commits
+   const auto author = commits.fieldStr(row, CommitInfo::Field::AUTHOR).section('<', 0, 0);
+   const auto committer = commits.fieldStr(row, CommitInfo::Field::COMMITER).section('<', 0, 0);
 
-   return commitIter != mCommits.constEnd() ? **commitIter : CommitInfo();
+   return QString("%1 %2 %3")
+       .arg(commits.fieldStr(row, CommitInfo::Field::SHORT_LOG), author, committer != author ? committer : QString());
 }
 
 CommitInfo RevisionsCache::getCommitInfo(const QString &sha) const
 {
    if (!sha.isEmpty())
    {
-      const auto c = mCommitsMap.value(sha, nullptr);
+      if (sha == CommitInfo::ZERO_SHA)
+         return mWipCommit;
+
+      const auto id = ObjectId::fromHex(sha);
+      const auto row = id.isNull() ? -1 : mCommits.findRow(id);
 
-      if (c == nullptr)
+      if (row == -1)
       {
-         const auto shas = mCommitsMap.keys();
-         const auto it = std::find_if(shas.cbegin(), shas.cend(),
-                                      [sha](const QString &shaToCompare) { return shaToCompare.startsWith(sha); });
+         const auto match = findCommitByPrefix(sha);
 
-         if (it != shas.cend())
-            return *mCommitsMap.value(*it);
+         if (match.isAmbiguous())
+            QLog_Debug("Git", QString("The abbreviated SHA {%1} is ambiguous.").arg(sha));
 
-         return CommitInfo();
+         return match.isUnique() ? mCommits.commit(match.row) : CommitInfo();
       }
 
-      return *c;
+      return mCommits.commit(row);
    }
 
    return CommitInfo();
 }
 
+ShaPrefixIndex::Match RevisionsCache::findCommitByPrefix(const QString &prefix) const
+{
+   if (mIsShaPrefixIndexOutdated)
+   {
+      mShaPrefixIndex.build(mCommits);
+      mIsShaPrefixIndexOutdated = false;
+   }
+
+   return mShaPrefixIndex.find(prefix);
+}
+
 RevisionFiles RevisionsCache::getRevisionFile(const QString &sha1, const QString &sha2) const
 {
-   return mRevisionFilesMap.value(qMakePair(sha1, sha2));
+   return mRevisionFilesMap.value(qMakePair(ObjectId::fromHex(sha1), ObjectId::fromHex(sha2)));
 }
 
-Reference RevisionsCache::getReference(const QString &sha) const
+Reference RevisionsCache::getReference(const ObjectId &sha) const
 {
    return mReferencesMap.value(sha, Reference());
 }
 
-void RevisionsCache::insertCommitInfo(CommitInfo rev)
+bool RevisionsCache::insertCommitInfo(CommitInfo rev)
 {
    if (mCacheLocked)
-      QLog_Warning("Git", QString("The cache is currently locked."));
-   else if (mCommitsMap.contains(rev.sha()))
-      QLog_Info("Git", QString("The commit with SHA {%1} is already in the cache.").arg(rev.sha()));
-   else
    {
-      updateLanes(rev);
-
-      const auto commit = new CommitInfo(rev);
-
-      if (rev.orderIdx >= mCommits.count())
-      {
-         QLog_Debug("Git", QString("Adding commit with sha {%1}.").arg(commit->sha()));
+      QLog_Warning("Git", QString("The cache is currently locked."));
+      return false;
+   }
 
-         mCommits.insert(rev.orderIdx, commit);
-      }
-      else if (!(mCommits[rev.orderIdx] && *mCommits[rev.orderIdx] == *commit))
-      {
-         QLog_Trace("Git", QString("Overwriting commit with sha {%1}.").arg(commit->sha()));
+   if (mCommits.findRow(rev.id()) != -1)
+   {
+      QLog_Info("Git", QString("The commit with SHA {%1} is already in the cache.").arg(rev.sha()));
+      return false;
+   }
 
-         delete mCommits[rev.orderIdx];
-         mCommits[rev.orderIdx] = commit;
-      }
+   // The lanes of the new row are computed when it's painted
+   const auto row = mCommits.append(rev);
+   mIsReachabilityOutdated = true;
+   mIsShaPrefixIndexOutdated = true;
 
-      mCommitsMap.insert(rev.sha(), commit);
+   indexCommit(row);
 
-      if (mCommitsMap.contains(rev.parent(0)))
-         mCommitsMap.remove(rev.parent(0));
-   }
+   return true;
 }
 
 bool RevisionsCache::insertRevisionFile(const QString &sha1, const QString &sha2, const RevisionFiles &file)
 {
-   const auto key = qMakePair(sha1, sha2);
+   const auto key = qMakePair(ObjectId::fromHex(sha1), ObjectId::fromHex(sha2));
 
-   if (!sha1.isEmpty() && !sha2.isEmpty() && mRevisionFilesMap.value(key) != file)
+   if (!key.first.isNull() && !key.second.isNull() && mRevisionFilesMap.value(key) != file)
    {
       QLog_Debug("Git", QString("Adding the revisions files between {%1} and {%2}.").arg(sha1, sha2));
 
@@ -132,18 +279,20 @@ bool RevisionsCache::insertRevisionFile(const QString &sha1, const QString &sha2
    return false;
 }
 
-void RevisionsCache::insertReference(const QString &sha, Reference ref)
+void RevisionsCache::insertReference(const ObjectId &sha, Reference ref)
 {
-   QLog_Debug("Git", QString("Adding a new reference with SHA {%1}.").arg(sha));
+   QLog_Debug("Git", QString("Adding a new reference with SHA {%1}.").arg(sha.toHex()));
 
    mReferencesMap[sha] = std::move(ref);
+   ++mReferencesRevision;
+   mIsReachabilityOutdated = true;
 }
 
 void RevisionsCache::updateWipCommit(const QString &parentSha, const QString &diffIndex, const QString &diffIndexCache)
 {
    QLog_Debug("Git", QString("Updating the WIP commit. The actual parent has SHA {%1}.").arg(parentSha));
 
-   const auto key = qMakePair(CommitInfo::ZERO_SHA, parentSha);
+   const auto key = qMakePair(CommitInfo::ZERO_ID, ObjectId::fromHex(parentSha));
    const auto fakeRevFile = fakeWorkDirRevFile(diffIndex, diffIndexCache);
    const auto revFileExists = mRevisionFilesMap.contains(key);
    const auto changed = insertRevisionFile(CommitInfo::ZERO_SHA, parentSha, fakeRevFile);
@@ -154,7 +303,7 @@ void RevisionsCache::updateWipCommit(const QString &parentSha, const QString &di
 
       while (iter != mRevisionFilesMap.end())
       {
-         if (iter.key().first == CommitInfo::ZERO_SHA || iter.key().second == CommitInfo::ZERO_SHA)
+         if (iter.key().first == CommitInfo::ZERO_ID || iter.key().second == CommitInfo::ZERO_ID)
             iter = mRevisionFilesMap.erase(iter);
          else
             ++iter;
@@ -171,69 +320,181 @@ void RevisionsCache::updateWipCommit(const QString &parentSha, const QString &di
                    longLog, 0);
       c.isDiffCache = true;
 
-      updateLanes(c);
+      const auto isNew = !mWipCommit.isValid();
 
-      if (mCommits[c.orderIdx])
-         c.lanes = mCommits[c.orderIdx]->lanes;
+      if (!isNew)
+         c.lanes = mWipCommit.lanes;
 
-      const auto sha = c.sha();
-      const auto commit = new CommitInfo(std::move(c));
+      mWipCommit = std::move(c);
 
-      delete mCommits[commit->orderIdx];
-      mCommits[commit->orderIdx] = commit;
-
-      mCommitsMap.insert(sha, commit);
+      if (isNew)
+         rebuildLanes();
    }
 }
 
-void RevisionsCache::removeReference(const QString &sha)
+void RevisionsCache::removeReference(const ObjectId &sha)
 {
    mReferencesMap.remove(sha);
+   ++mReferencesRevision;
+   mIsReachabilityOutdated = true;
+}
+
+void RevisionsCache::clearReferences()
+{
+   mReferencesMap.clear();
+   ++mReferencesRevision;
+   mIsReachabilityOutdated = true;
+}
+
+bool RevisionsCache::getBranchesContaining(const ObjectId &sha, QStringList &branches) const
+{
+   const auto row = mCommits.findRow(sha);
+
+   branches = row != -1 ? reachability().branchesContaining(row) : QStringList();
+
+   return row != -1 && mAreAllTipsLoaded;
+}
+
+bool RevisionsCache::isAncestor(const ObjectId &ancestor, const ObjectId &sha) const
+{
+   return reachability().isAncestor(mCommits.findRow(ancestor), mCommits.findRow(sha));
+}
+
+ObjectId RevisionsCache::getHeadId() const
+{
+   for (auto iter = mReferencesMap.cbegin(); iter != mReferencesMap.cend(); ++iter)
+   {
+      if (iter.value().type & CUR_BRANCH)
+         return iter.key();
+   }
+
+   return ObjectId();
+}
+
+const ReachabilityIndex &RevisionsCache::reachability() const
+{
+   if (mIsReachabilityOutdated)
+   {
+      QVector<QPair<QString, int>> tips;
+      mAreAllTipsLoaded = true;
+
+      for (auto iter = mReferencesMap.cbegin(); iter != mReferencesMap.cend(); ++iter)
+      {
+         const auto &ref = iter.value();
+
+         if (ref.branches.isEmpty() && ref.remoteBranches.isEmpty())
+            continue;
+
+         const auto row = mCommits.findRow(iter.key());
+
+         mAreAllTipsLoaded = mAreAllTipsLoaded && row != -1;
+
+         for (const auto &branch : ref.branches + ref.remoteBranches)
+            tips.append(qMakePair(branch, row));
+      }
+
+      mReachability.build(mCommits, tips);
+      mIsReachabilityOutdated = false;
+   }
+
+   return mReachability;
+}
+
+bool RevisionsCache::getLongLog(const ObjectId &sha, QString &longLog) const
+{
+   const auto cached = mLongLogs.object(sha);
+
+   if (cached)
+      longLog = *cached;
+
+   return cached != nullptr;
+}
+
+QVector<ObjectId> RevisionsCache::getMissingLongLogs(const ObjectId &sha, int count) const
+{
+   QVector<ObjectId> missing { sha };
+   const auto row = mCommits.findRow(sha);
+
+   if (row != -1)
+   {
+      for (auto i = row + 1; i < mCommits.count() && missing.count() < count; ++i)
+      {
+         const auto id = mCommits.id(i);
+
+         if (!id.isNull() && !mLongLogs.contains(id))
+            missing.append(id);
+      }
+   }
+
+   return missing;
+}
+
+void RevisionsCache::insertLongLog(const ObjectId &sha, const QString &longLog)
+{
+   // QCache would drop a body bigger than the whole cache right away, so it isn't kept. The caller still has it.
+   if (longLog.size() < MAX_LONG_LOGS_SIZE)
+      mLongLogs.insert(sha, new QString(longLog), longLog.size() + 1);
+
+   const auto row = mCommits.findRow(sha);
+
+   if (row != -1 && mCommits.rowId(row) != -1)
+      indexText(mCommits.rowId(row), longLog);
 }
 
 bool RevisionsCache::containsRevisionFile(const QString &sha1, const QString &sha2) const
 {
-   return mRevisionFilesMap.contains(qMakePair(sha1, sha2));
+   return mRevisionFilesMap.contains(qMakePair(ObjectId::fromHex(sha1), ObjectId::fromHex(sha2)));
 }
 
-void RevisionsCache::updateLanes(CommitInfo &c)
+void RevisionsCache::insertCommits(int row, const QVector<CommitInfo> &commits)
 {
-   const auto sha = c.sha();
+   mCommits.insert(row, commits);
+   mIsReachabilityOutdated = true;
+   mIsShaPrefixIndexOutdated = true;
 
-   QLog_Trace("Git", QString("Updating the lanes for SHA {%1}.").arg(sha));
+   for (auto i = row; i < row + commits.count(); ++i)
+      indexCommit(i);
 
-   if (mLanes.isEmpty())
-      mLanes.init(c.sha());
+   // The rows above the new ones keep their lanes
+   mLanes.invalidate(row);
+}
 
-   bool isDiscontinuity;
-   bool isFork = mLanes.isFork(sha, isDiscontinuity);
-   bool isMerge = (c.parentsCount() > 1);
-   bool isInitial = (c.parentsCount() == 0);
+int RevisionsCache::updateCommitDetails(const CommitInfo &commit)
+{
+   const auto row = mCommits.findRow(commit.id());
 
-   if (isDiscontinuity)
-      mLanes.changeActiveLane(sha); // uses previous isBoundary state
+   if (row != -1)
+   {
+      mCommits.setDetails(row, commit);
+      indexCommit(row);
+   }
 
-   mLanes.setBoundary(c.isBoundary()); // update must be here
+   return row;
+}
 
-   if (isFork)
-      mLanes.setFork(sha);
-   if (isMerge)
-      mLanes.setMerge(c.parents());
-   if (isInitial)
-      mLanes.setInitial();
+void RevisionsCache::setCommits(CommitStore commits)
+{
+   mCommits = std::move(commits);
+   mIsReachabilityOutdated = true;
+   mIsShaPrefixIndexOutdated = true;
 
-   mLanes.setLanes(c.lanes); // here lanes are snapshotted
+   resetSearchIndex();
+   rebuildLanes();
+}
 
-   const auto nextSha = isInitial ? QString() : c.parent(0);
+void RevisionsCache::rebuildLanes()
+{
+   // The lanes of a commit depend on all the commits above it, so the checkpoints start again from the WIP commit. The
+   // rows are replayed the next time they are painted.
+   Lanes lanes;
 
-   mLanes.nextParent(nextSha);
+   if (mWipCommit.isValid())
+   {
+      mWipCommit.lanes = lanes.update(mCommits.internId(mWipCommit.id()), mCommits.internIds(mWipCommit.parentIds()),
+                                      mWipCommit.isBoundary());
+   }
 
-   if (isMerge)
-      mLanes.afterMerge();
-   if (isFork)
-      mLanes.afterFork();
-   if (mLanes.isBranch())
-      mLanes.afterBranch();
+   mLanes.reset(lanes);
 }
 
 RevisionFiles RevisionsCache::parseDiffFormat(const QString &buf, FileNamesLoader &fl)
@@ -338,19 +599,18 @@ void RevisionsCache::flushFileNames(FileNamesLoader &fl)
 
 bool RevisionsCache::pendingLocalChanges() const
 {
-   const auto commit = mCommitsMap.value(CommitInfo::ZERO_SHA);
-   const auto rf = getRevisionFile(CommitInfo::ZERO_SHA, commit->parent(0));
+   const auto rf = getRevisionFile(CommitInfo::ZERO_SHA, mWipCommit.parent(0));
    return rf.count() == mUntrackedfiles.count();
 }
 
-uint RevisionsCache::checkRef(const QString &sha, uint mask) const
+uint RevisionsCache::checkRef(const ObjectId &sha, uint mask) const
 {
    const auto ref = getReference(sha);
 
    return ref.isValid() ? ref.type & mask : 0;
 }
 
-const QStringList RevisionsCache::getRefNames(const QString &sha, uint mask) const
+const QStringList RevisionsCache::getRefNames(const ObjectId &sha, uint mask) const
 {
    QStringList result;
    if (!checkRef(sha, mask))
@@ -425,22 +685,24 @@ void RevisionsCache::setExtStatus(RevisionFiles &rf, const QString &rowSt, int p
    rf.setOnlyModified(false);
 }
 
-QVector<CommitInfo *>::const_iterator RevisionsCache::searchCommit(CommitInfo::Field field, const QString &text,
-                                                                   const int startingPoint) const
-{
-   return std::find_if(mCommits.constBegin() + startingPoint, mCommits.constEnd(),
-                       [field, text](CommitInfo *info) { return info->getFieldStr(field).contains(text); });
-}
-
 void RevisionsCache::clear()
 {
    mCacheLocked = true;
+   mCommits.clear();
+   mWipCommit = CommitInfo();
    mDirNames.clear();
    mFileNames.clear();
    mRevisionFilesMap.clear();
    mReferencesMap.clear();
-   mLanes.clear();
-   mCommitsMap.clear();
+   ++mReferencesRevision;
+   mLongLogs.clear();
+   mLanes.reset();
+   mReachability.clear();
+   mIsReachabilityOutdated = true;
+   mShaPrefixIndex.clear();
+   mIsShaPrefixIndexOutdated = true;
+
+   resetSearchIndex();
 }
 
 int RevisionsCache::count() const
@@ -26,10 +26,16 @@
 #include <RevisionFiles.h>
 #include <lanes.h>
 #include <CommitInfo.h>
+#include <CommitStore.h>
+#include <CommitSearchIndex.h>
+#include <GraphLanes.h>
 #include <Reference.h>
+#include <ReachabilityIndex.h>
+#include <ShaPrefixIndex.h>
 
 #include <QObject>
 #include <QHash>
+#include <QCache>
 
 struct WorkingDirInfo;
 
@@ -42,7 +48,6 @@ signals:
 
 public:
    explicit RevisionsCache(QObject *parent = nullptr);
-   ~RevisionsCache();
 
    void configure(int numElementsToStore);
    void clear();
@@ -50,19 +55,46 @@ public:
    int count() const;
    int countReferences() const;
 
+   // The SHA can be abbreviated. If more than one commit starts by it, no commit is returned.
    CommitInfo getCommitInfo(const QString &sha) const;
+   ShaPrefixIndex::Match findCommitByPrefix(const QString &prefix) const;
    CommitInfo getCommitInfoByRow(int row) const;
-   CommitInfo getCommitInfoByField(CommitInfo::Field field, const QString &text, int startingPoint = 0);
+   ObjectId getCommitIdByRow(int row) const;
+   // Computes the lanes of the row into the vector, reusing its memory. Only the rows that are painted need them, so
+   // they are replayed from the closest checkpoint when they are asked for.
+   void getLanes(int row, QVector<LaneType> &lanes) const;
+   // Rows of the commits whose message, body, author or committer have all the words of the text, in order. Until the
+   // index is ready, only the bodies that were shown are searched.
+   QVector<int> findCommits(const QString &text) const;
+   // Builds the search index in the background with the commits loaded so far, false if it's already built or being
+   // built. The commits that arrive later are added to it as they come.
+   bool buildSearchIndex();
+   // Adds the bodies to the search index. The records are "<SHA>\n<body>", separated by NUL.
+   void indexBodies(const QByteArray &records);
    RevisionFiles getRevisionFile(const QString &sha1, const QString &sha2) const;
-   Reference getReference(const QString &sha) const;
-
-   void insertCommitInfo(CommitInfo rev);
+   Reference getReference(const ObjectId &sha) const;
+   QHash<ObjectId, Reference> getReferences() const { return mReferencesMap; }
+   // Changes every time a reference is added or removed, so the views know when their copies are outdated
+   int getReferencesRevision() const { return mReferencesRevision; }
+
+   // Returns false if the commit was not inserted, because it is already known or the cache is locked
+   bool insertCommitInfo(CommitInfo rev);
+   void insertCommits(int row, const QVector<CommitInfo> &commits);
+   int updateCommitDetails(const CommitInfo &commit);
+   const CommitStore &commits() const { return mCommits; }
+   void setCommits(CommitStore commits);
+   void rebuildLanes();
 
    bool insertRevisionFile(const QString &sha1, const QString &sha2, const RevisionFiles &file);
-   void insertReference(const QString &sha, Reference ref);
+   void insertReference(const ObjectId &sha, Reference ref);
    void updateWipCommit(const QString &parentSha, const QString &diffIndex, const QString &diffIndexCache);
 
-   void removeReference(const QString &sha);
+   void removeReference(const ObjectId &sha);
+
+   bool getLongLog(const ObjectId &sha, QString &longLog) const;
+   QVector<ObjectId> getMissingLongLogs(const ObjectId &sha, int count) const;
+   void insertLongLog(const ObjectId &sha, const QString &longLog);
+   void clearReferences();
 
    bool containsRevisionFile(const QString &sha1, const QString &sha2) const;
 
@@ -71,19 +103,56 @@ public:
    void setUntrackedFilesList(const QVector<QString> &untrackedFiles);
    bool pendingLocalChanges() const;
 
-   uint checkRef(const QString &sha, uint mask = ANY_REF) const;
-   const QStringList getRefNames(const QString &sha, uint mask) const;
+   uint checkRef(const ObjectId &sha, uint mask = ANY_REF) const;
+   uint checkRef(const QString &sha, uint mask = ANY_REF) const { return checkRef(ObjectId::fromHex(sha), mask); }
+   const QStringList getRefNames(const ObjectId &sha, uint mask) const;
+   const QStringList getRefNames(const QString &sha, uint mask) const
+   {
+      return getRefNames(ObjectId::fromHex(sha), mask);
+   }
+
+   // Local and remote branches that contain the commit. It returns false if the tip of some branch is not loaded, since
+   // the list could be incomplete.
+   bool getBranchesContaining(const ObjectId &sha, QStringList &branches) const;
+   // Whether the first commit is the second one or one of its ancestors, false if any of them is not loaded
+   bool isAncestor(const ObjectId &ancestor, const ObjectId &sha) const;
+   ObjectId getHeadId() const;
+
+   qint64 memoryFootprint() const { return mCommits.memoryFootprint(); }
+   qint64 legacyMemoryFootprint() const { return mCommits.legacyMemoryFootprint(); }
 
 private:
    bool mCacheLocked = true;
-   QVector<CommitInfo *> mCommits;
-   QHash<QString, CommitInfo *> mCommitsMap;
-   QHash<QPair<QString, QString>, RevisionFiles> mRevisionFilesMap;
-   QHash<QString, Reference> mReferencesMap;
-   Lanes mLanes;
+   CommitStore mCommits;
+   CommitInfo mWipCommit;
+   QHash<QPair<ObjectId, ObjectId>, RevisionFiles> mRevisionFilesMap;
+   QHash<ObjectId, Reference> mReferencesMap;
+   int mReferencesRevision = 0;
+   QCache<ObjectId, QString> mLongLogs;
+   mutable GraphLanes mLanes;
    QVector<QString> mDirNames;
    QVector<QString> mFileNames;
    QVector<QString> mUntrackedfiles;
+   // Built on the first query after the commits or the references change
+   mutable ReachabilityIndex mReachability;
+   mutable bool mIsReachabilityOutdated = true;
+   mutable bool mAreAllTipsLoaded = false;
+   mutable ShaPrefixIndex mShaPrefixIndex;
+   mutable bool mIsShaPrefixIndexOutdated = true;
+
+   enum class SearchIndexState
+   {
+      NotBuilt,
+      Building,
+      Ready
+   };
+
+   CommitSearchIndex mSearchIndex;
+   SearchIndexState mSearchIndexState = SearchIndexState::NotBuilt;
+   // The builds of a previous history are discarded
+   int mSearchIndexGeneration = 0;
+   // Texts that arrive while the index is built in the background
+   QVector<QPair<int, QString>> mPendingSearchTexts;
 
    struct FileNamesLoader
    {
@@ -99,11 +168,13 @@ private:
    };
 
    RevisionFiles fakeWorkDirRevFile(const QString &diffIndex, const QString &diffIndexCache);
-   void updateLanes(CommitInfo &c);
    RevisionFiles parseDiffFormat(const QString &buf, FileNamesLoader &fl);
    void appendFileName(const QString &name, FileNamesLoader &fl);
    void flushFileNames(FileNamesLoader &fl);
    void setExtStatus(RevisionFiles &rf, const QString &rowSt, int parNum, FileNamesLoader &fl);
-   QVector<CommitInfo *>::const_iterator searchCommit(CommitInfo::Field field, const QString &text,
-                                                      int startingPoint = 0) const;
+   const ReachabilityIndex &reachability() const;
+   void indexCommit(int row);
+   void indexText(int id, const QString &text);
+   void resetSearchIndex();
+   static QString searchText(const CommitStore &commits, int row);
 };
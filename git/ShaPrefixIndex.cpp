@@ -0,0 +1,59 @@
+#include "ShaPrefixIndex.h"
+
+#include <CommitStore.h>
+
+#include <algorithm>
+
+void ShaPrefixIndex::build(const CommitStore &commits)
+{
+   clear();
+
+   mCommits = &commits;
+   mSortedRows.reserve(commits.count());
+
+   for (auto row = 0; row < commits.count(); ++row)
+   {
+      // The WIP row has no SHA
+      if (commits.rowId(row) != -1)
+         mSortedRows.append(row);
+   }
+
+   std::sort(mSortedRows.begin(), mSortedRows.end(),
+             [&commits](int first, int second) { return commits.id(first) < commits.id(second); });
+
+   mHexSize = mSortedRows.isEmpty() ? 0 : 2 * commits.id(mSortedRows.constFirst()).size();
+}
+
+void ShaPrefixIndex::clear()
+{
+   mCommits = nullptr;
+   mSortedRows.clear();
+   mHexSize = 0;
+}
+
+ShaPrefixIndex::Match ShaPrefixIndex::find(const QString &prefix) const
+{
+   Match match;
+
+   if (!mCommits || prefix.isEmpty() || prefix.size() > mHexSize)
+      return match;
+
+   // All the SHAs with the prefix are between the prefix completed with zeros and the prefix completed with Fs
+   const auto lowest = ObjectId::fromHex(prefix.toLower().leftJustified(mHexSize, '0'));
+   const auto highest = ObjectId::fromHex(prefix.toLower().leftJustified(mHexSize, 'f'));
+
+   if (lowest.isNull() || highest.isNull())
+      return match;
+
+   const auto commits = mCommits;
+   const auto first = std::lower_bound(mSortedRows.cbegin(), mSortedRows.cend(), lowest,
+                                       [commits](int row, const ObjectId &id) { return commits->id(row) < id; });
+
+   for (auto it = first; it != mSortedRows.cend() && match.count < 2 && !(highest < mCommits->id(*it)); ++it)
+      ++match.count;
+
+   if (match.count == 1)
+      match.row = *first;
+
+   return match;
+}
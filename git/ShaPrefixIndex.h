@@ -0,0 +1,58 @@
+#pragma once
+
+/****************************************************************************************
+ ** GitQlient is an application to manage and operate one or several Git repositories. With
+ ** GitQlient you will be able to add commits, branches and manage all the options Git provides.
+ ** Copyright (C) 2019  Francesc Martinez
+ **
+ ** LinkedIn: www.linkedin.com/in/cescmm/
+ ** Web: www.francescmm.com
+ **
+ ** This program is free software; you can redistribute it and/or
+ ** modify it under the terms of the GNU Lesser General Public
+ ** License as published by the Free Software Foundation; either
+ ** version 2 of the License, or (at your option) any later version.
+ **
+ ** This program is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ ** Lesser General Public License for more details.
+ **
+ ** You should have received a copy of the GNU Lesser General Public
+ ** License along with this library; if not, write to the Free Software
+ ** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ***************************************************************************************/
+
+#include <QString>
+#include <QVector>
+
+class CommitStore;
+
+// Index to resolve abbreviated SHAs among the commits of a CommitStore. It keeps the rows sorted by SHA, so the commits
+// that start by a prefix are all together and found with a binary search.
+class ShaPrefixIndex
+{
+public:
+   struct Match
+   {
+      // Row of the commit if it is the only one with the prefix, -1 otherwise
+      int row = -1;
+      // Number of commits with the prefix, up to 2
+      int count = 0;
+
+      bool isUnique() const { return count == 1; }
+      bool isAmbiguous() const { return count > 1; }
+   };
+
+   ShaPrefixIndex() = default;
+
+   void build(const CommitStore &commits);
+   void clear();
+
+   Match find(const QString &prefix) const;
+
+private:
+   const CommitStore *mCommits = nullptr;
+   QVector<int> mSortedRows;
+   int mHexSize = 0;
+};
@@ -6,21 +6,59 @@
         Copyright: See COPYING file that comes with this distribution
 
 */
-#include <QStringList>
 #include "lanes.h"
 
-void Lanes::init(const QString &expectedSha)
+void Lanes::init(int expectedId)
 {
    clear();
    activeLane = 0;
    setBoundary(false);
-   add(LaneType::BRANCH, expectedSha, activeLane);
+   add(LaneType::BRANCH, expectedId, activeLane);
+}
+
+QVector<LaneType> Lanes::update(int id, const QVector<int> &parentIds, bool isBoundary)
+{
+   if (isEmpty())
+      init(id);
+
+   bool isDiscontinuity;
+   const auto fork = isFork(id, isDiscontinuity);
+   bool isMerge = (parentIds.count() > 1);
+   bool isInitial = (parentIds.count() == 0);
+
+   if (isDiscontinuity)
+      changeActiveLane(id); // uses previous isBoundary state
+
+   setBoundary(isBoundary); // update must be here
+
+   if (fork)
+      setFork(id);
+   if (isMerge)
+      setMerge(parentIds);
+   if (isInitial)
+      setInitial();
+
+   QVector<LaneType> lanes;
+   setLanes(lanes); // here lanes are snapshotted
+
+   const auto nextId = isInitial ? -1 : parentIds.first();
+
+   nextParent(nextId);
+
+   if (isMerge)
+      afterMerge();
+   if (fork)
+      afterFork();
+   if (isBranch())
+      afterBranch();
+
+   return lanes;
 }
 
 void Lanes::clear()
 {
    typeVec.clear();
-   nextShaVec.clear();
+   nextIdVec.clear();
 }
 
 void Lanes::setBoundary(bool b)
@@ -34,25 +72,25 @@ void Lanes::setBoundary(bool b)
       typeVec[activeLane] = (LaneType::BOUNDARY);
 }
 
-bool Lanes::isFork(const QString &sha, bool &isDiscontinuity)
+bool Lanes::isFork(int id, bool &isDiscontinuity)
 {
-   int pos = findNextSha(sha, 0);
+   int pos = findNextId(id, 0);
    isDiscontinuity = activeLane != pos;
 
-   return pos == -1 ? false : findNextSha(sha, pos + 1) != -1;
+   return pos == -1 ? false : findNextId(id, pos + 1) != -1;
 }
 
-void Lanes::setFork(const QString &sha)
+void Lanes::setFork(int id)
 {
    auto rangeEnd = 0;
    auto idx = 0;
-   auto rangeStart = rangeEnd = idx = findNextSha(sha, 0);
+   auto rangeStart = rangeEnd = idx = findNextId(id, 0);
 
    while (idx != -1)
    {
       rangeEnd = idx;
       typeVec[idx] = LaneType::TAIL;
-      idx = findNextSha(sha, idx + 1);
+      idx = findNextId(id, idx + 1);
    }
    typeVec[activeLane] = (NODE);
 
@@ -82,7 +120,7 @@ void Lanes::setFork(const QString &sha)
    }
 }
 
-void Lanes::setMerge(const QStringList &parents)
+void Lanes::setMerge(const QVector<int> &parents)
 {
    if (boundary)
       return; // handle as a simple active line
@@ -98,11 +136,11 @@ void Lanes::setMerge(const QStringList &parents)
 
    auto rangeStart = activeLane;
    auto rangeEnd = activeLane;
-   QStringList::const_iterator it(parents.constBegin());
+   auto it = parents.constBegin();
 
    for (++it; it != parents.constEnd(); ++it)
    { // skip first parent
-      int idx = findNextSha(*it, 0);
+      int idx = findNextId(*it, 0);
 
       if (idx != -1)
       {
@@ -166,7 +204,7 @@ void Lanes::setInitial()
       t = boundary ? LaneType::BOUNDARY : LaneType::INITIAL;
 }
 
-void Lanes::changeActiveLane(const QString &sha)
+void Lanes::changeActiveLane(int id)
 {
    auto &t = typeVec[activeLane];
    if (t == LaneType::INITIAL || isBoundary(t))
@@ -174,11 +212,11 @@ void Lanes::changeActiveLane(const QString &sha)
    else
       t = LaneType::NOT_ACTIVE;
 
-   int idx = findNextSha(sha, 0); // find first sha
+   int idx = findNextId(id, 0); // find first id
    if (idx != -1)
       typeVec[idx] = (LaneType::ACTIVE); // called before setBoundary()
    else
-      idx = add(LaneType::BRANCH, sha, activeLane); // new branch
+      idx = add(LaneType::BRANCH, id, activeLane); // new branch
 
    activeLane = idx;
 }
@@ -223,7 +261,7 @@ void Lanes::afterFork()
    while (typeVec.last() == LaneType::EMPTY)
    {
       typeVec.pop_back();
-      nextShaVec.pop_back();
+      nextIdVec.pop_back();
    }
 }
 
@@ -237,15 +275,18 @@ void Lanes::afterBranch()
    typeVec[activeLane] = (LaneType::ACTIVE); // TODO test with boundaries
 }
 
-void Lanes::nextParent(const QString &sha)
+void Lanes::nextParent(int id)
 {
-   nextShaVec[activeLane] = boundary ? QString() : sha;
+   nextIdVec[activeLane] = boundary ? -1 : id;
 }
 
-int Lanes::findNextSha(const QString &next, int pos)
+int Lanes::findNextId(int next, int pos) const
 {
-   for (int i = pos; i < nextShaVec.count(); i++)
-      if (nextShaVec[i] == next)
+   const auto ids = nextIdVec.constData();
+   const auto idsCount = nextIdVec.count();
+
+   for (int i = pos; i < idsCount; i++)
+      if (ids[i] == next)
          return i;
    return -1;
 }
@@ -261,7 +302,7 @@ int Lanes::findType(const LaneType type, int pos)
    return -1;
 }
 
-int Lanes::add(const LaneType type, const QString &next, int pos)
+int Lanes::add(const LaneType type, int next, int pos)
 {
    // first check empty lanes starting from pos
    if (pos < typeVec.count())
@@ -270,13 +311,13 @@ int Lanes::add(const LaneType type, const QString &next, int pos)
       if (pos != -1)
       {
          typeVec[pos] = (type);
-         nextShaVec[pos] = next;
+         nextIdVec[pos] = next;
          return pos;
       }
    }
    // if all lanes are occupied add a new lane
    typeVec.append((type));
-   nextShaVec.append(next);
+   nextIdVec.append(next);
    return typeVec.count() - 1;
 }
 
@@ -7,14 +7,11 @@
 #ifndef LANES_H
 #define LANES_H
 
-#include <QString>
 #include <QVector>
 
-class QStringList;
-
 //
 //  At any given time, the Lanes class represents a single revision (row) of the history graph.
-//  The Lanes class contains a vector of the sha1 hashes of the next commit to appear in each lane (column).
+//  The Lanes class contains a vector of the ids of the next commit to appear in each lane (column).
 //  The Lanes class also contains a vector used to decide which glyph to draw on the history graph.
 //
 //  For each revision (row) (from recent (top) to ancient past (bottom)), the Lanes class is updated, and the
@@ -88,32 +85,34 @@ class Lanes
 public:
    Lanes() {} // init() will setup us later, when data is available
    bool isEmpty() { return typeVec.empty(); }
-   void init(const QString &expectedSha);
+   void init(int expectedId);
    void clear();
-   bool isFork(const QString &sha, bool &isDiscontinuity);
+   // Computes the glyphs of the commit and moves the lanes to the next row
+   QVector<LaneType> update(int id, const QVector<int> &parentIds, bool isBoundary);
+   bool isFork(int id, bool &isDiscontinuity);
    void setBoundary(bool isBoundary);
-   void setFork(const QString &sha);
-   void setMerge(const QStringList &parents);
+   void setFork(int id);
+   void setMerge(const QVector<int> &parents);
    void setInitial();
-   void changeActiveLane(const QString &sha);
+   void changeActiveLane(int id);
    void afterMerge();
    void afterFork();
    bool isBranch();
    void afterBranch();
-   void nextParent(const QString &sha);
+   void nextParent(int id);
    void setLanes(QVector<LaneType> &ln) { ln = typeVec; } // O(1) vector is implicitly shared
 
 private:
-   int findNextSha(const QString &next, int pos);
+   int findNextId(int next, int pos) const;
    int findType(LaneType type, int pos);
-   int add(LaneType type, const QString &next, int pos);
+   int add(LaneType type, int next, int pos);
    bool isNode(LaneType laneType) const;
 
-   int activeLane;
+   int activeLane = 0;
    QVector<LaneType> typeVec; // Describes which glyphs should be drawn.
-   QVector<QString> nextShaVec; // The sha1 hashes of the next commit to appear in each lane (column).
-   bool boundary;
-   LaneType NODE, NODE_L, NODE_R;
+   QVector<int> nextIdVec; // The ids of the next commit to appear in each lane (column), -1 if none.
+   bool boundary = false;
+   LaneType NODE = LaneType::MERGE_FORK, NODE_L = LaneType::MERGE_FORK_L, NODE_R = LaneType::MERGE_FORK_R;
 };
 
 #endif
@@ -0,0 +1,123 @@
+#include "CommitFilterBar.h"
+
+#include <QDateEdit>
+#include <QHBoxLayout>
+#include <QLabel>
+#include <QLineEdit>
+#include <QPushButton>
+
+namespace
+{
+// The minimum date of the date fields means that there is no limit
+const QDate ANY_DATE(1970, 1, 1);
+
+QDateEdit *createDateEdit()
+{
+   const auto dateEdit = new QDateEdit();
+   dateEdit->setCalendarPopup(true);
+   dateEdit->setDisplayFormat("dd MMM yyyy");
+   dateEdit->setMinimumDate(ANY_DATE);
+   dateEdit->setSpecialValueText(QObject::tr("Any date"));
+   dateEdit->setDate(ANY_DATE);
+
+   return dateEdit;
+}
+}
+
+CommitFilterBar::CommitFilterBar(QWidget *parent)
+   : QFrame(parent)
+   , mAuthor(new QLineEdit())
+   , mCommitter(new QLineEdit())
+   , mMessage(new QLineEdit())
+   , mFrom(createDateEdit())
+   , mTo(createDateEdit())
+   , mMatches(new QLabel())
+{
+   mAuthor->setPlaceholderText(tr("Author"));
+   mCommitter->setPlaceholderText(tr("Committer"));
+   mMessage->setPlaceholderText(tr("Message (regular expression)"));
+
+   connect(mAuthor, &QLineEdit::editingFinished, this, &CommitFilterBar::applyFilter);
+   connect(mCommitter, &QLineEdit::editingFinished, this, &CommitFilterBar::applyFilter);
+   connect(mMessage, &QLineEdit::editingFinished, this, &CommitFilterBar::applyFilter);
+   connect(mFrom, &QDateEdit::dateChanged, this, &CommitFilterBar::applyFilter);
+   connect(mTo, &QDateEdit::dateChanged, this, &CommitFilterBar::applyFilter);
+
+   const auto clearBtn = new QPushButton(tr("Clear"));
+   connect(clearBtn, &QPushButton::clicked, this, &CommitFilterBar::clear);
+
+   const auto layout = new QHBoxLayout(this);
+   layout->setContentsMargins(QMargins());
+   layout->setSpacing(10);
+   layout->addWidget(mAuthor);
+   layout->addWidget(mCommitter);
+   layout->addWidget(mMessage, 2);
+   layout->addWidget(new QLabel(tr("From")));
+   layout->addWidget(mFrom);
+   layout->addWidget(new QLabel(tr("To")));
+   layout->addWidget(mTo);
+   layout->addWidget(mMatches);
+   layout->addWidget(clearBtn);
+}
+
+void CommitFilterBar::clear()
+{
+   // The signals of each field would apply the filter once per field
+   for (const auto lineEdit : { mAuthor, mCommitter, mMessage })
+   {
+      lineEdit->blockSignals(true);
+      lineEdit->clear();
+      lineEdit->blockSignals(false);
+   }
+
+   for (const auto dateEdit : { mFrom, mTo })
+   {
+      dateEdit->blockSignals(true);
+      dateEdit->setDate(ANY_DATE);
+      dateEdit->blockSignals(false);
+   }
+
+   applyFilter();
+}
+
+void CommitFilterBar::setMatches(int matches)
+{
+   mMatches->setText(tr("%1 commits").arg(matches));
+}
+
+void CommitFilterBar::applyFilter()
+{
+   CommitFilter filter;
+   filter.author = mAuthor->text().trimmed();
+   filter.committer = mCommitter->text().trimmed();
+
+   if (!mMessage->text().isEmpty())
+   {
+      filter.message = QRegularExpression(mMessage->text(), QRegularExpression::CaseInsensitiveOption);
+
+      if (!filter.message.isValid())
+      {
+         mMessage->setToolTip(filter.message.errorString());
+         return;
+      }
+   }
+
+   mMessage->setToolTip(QString());
+
+   if (mFrom->date() != ANY_DATE)
+      filter.from = mFrom->date();
+
+   if (mTo->date() != ANY_DATE)
+      filter.to = mTo->date();
+
+   // Leaving a field without changes doesn't filter again
+   if (filter == mFilter)
+      return;
+
+   mFilter = filter;
+
+   if (filter.isEmpty())
+      mMatches->clear();
+
+   emit signalFilterChanged(filter);
+}
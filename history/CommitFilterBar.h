@@ -23,22 +23,37 @@
  ** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
  ***************************************************************************************/
 
-#include <QSortFilterProxyModel>
+#include <CommitFilter.h>
 
-class ShaFilterProxyModel : public QSortFilterProxyModel
+#include <QFrame>
+
+class QLineEdit;
+class QDateEdit;
+class QLabel;
+
+// Bar with the fields to filter the history by author, committer, message and dates. The filter changes when a field
+// is edited, and it's empty when the bar is cleared.
+class CommitFilterBar : public QFrame
 {
    Q_OBJECT
 
-public:
-   explicit ShaFilterProxyModel(QObject *parent = nullptr);
+signals:
+   void signalFilterChanged(const CommitFilter &filter);
 
-   void setAcceptedSha(const QStringList &acceptedShaList) { mAcceptedShas = acceptedShaList; }
-   void beginResetModel() { QSortFilterProxyModel::beginResetModel(); }
-   void endResetModel() { QSortFilterProxyModel::endResetModel(); }
+public:
+   explicit CommitFilterBar(QWidget *parent = nullptr);
 
-protected:
-   bool filterAcceptsRow(int sourceRow, const QModelIndex &sourceParent) const override;
+   void clear();
+   void setMatches(int matches);
 
 private:
-   QStringList mAcceptedShas;
+   QLineEdit *mAuthor = nullptr;
+   QLineEdit *mCommitter = nullptr;
+   QLineEdit *mMessage = nullptr;
+   QDateEdit *mFrom = nullptr;
+   QDateEdit *mTo = nullptr;
+   QLabel *mMatches = nullptr;
+   CommitFilter mFilter;
+
+   void applyFilter();
 };
@@ -0,0 +1,361 @@
+#include "CommitFilterProxyModel.h"
+
+#include <CommitHistoryColumns.h>
+#include <GraphAlgorithms.h>
+#include <RevisionsCache.h>
+
+#include <QFutureWatcher>
+#include <QtConcurrent>
+
+#include <algorithm>
+
+#include <QLogger.h>
+using namespace QLogger;
+
+namespace
+{
+// Rows filtered by each job of the worker threads
+const int FILTER_CHUNK_SIZE = 4096;
+}
+
+CommitFilterProxyModel::CommitFilterProxyModel(const QSharedPointer<RevisionsCache> &cache, QObject *parent)
+   : QAbstractProxyModel(parent)
+   , mCache(cache)
+{
+}
+
+void CommitFilterProxyModel::setSourceModel(QAbstractItemModel *model)
+{
+   if (const auto previousModel = sourceModel())
+   {
+      disconnect(previousModel, &QAbstractItemModel::modelReset, this, &CommitFilterProxyModel::refresh);
+      disconnect(previousModel, &QAbstractItemModel::rowsInserted, this, &CommitFilterProxyModel::onSourceRowsInserted);
+      disconnect(previousModel, &QAbstractItemModel::rowsRemoved, this, &CommitFilterProxyModel::refresh);
+      disconnect(previousModel, &QAbstractItemModel::dataChanged, this, &CommitFilterProxyModel::onSourceDataChanged);
+   }
+
+   QAbstractProxyModel::setSourceModel(model);
+
+   connect(model, &QAbstractItemModel::modelReset, this, &CommitFilterProxyModel::refresh);
+   connect(model, &QAbstractItemModel::rowsInserted, this, &CommitFilterProxyModel::onSourceRowsInserted);
+   connect(model, &QAbstractItemModel::rowsRemoved, this, &CommitFilterProxyModel::refresh);
+   connect(model, &QAbstractItemModel::dataChanged, this, &CommitFilterProxyModel::onSourceDataChanged);
+
+   refresh();
+}
+
+void CommitFilterProxyModel::setAcceptedCommits(const QVector<ObjectId> &ids)
+{
+   mMode = Mode::Commits;
+   mAcceptedCommits = ids;
+   mFilter = CommitFilter();
+
+   refresh();
+}
+
+void CommitFilterProxyModel::setFilter(const CommitFilter &filter)
+{
+   mMode = Mode::Filter;
+   mAcceptedCommits.clear();
+   mFilter = filter;
+
+   refresh();
+}
+
+bool CommitFilterProxyModel::lanes(int proxyRow, QVector<LaneType> &lanes) const
+{
+   if (mLanes.count() != mSourceRows.count() || proxyRow < 0 || proxyRow >= mLanes.count())
+      return false;
+
+   lanes = mLanes.at(proxyRow);
+
+   return true;
+}
+
+QModelIndex CommitFilterProxyModel::index(int row, int column, const QModelIndex &parent) const
+{
+   if (parent.isValid() || row < 0 || row >= mSourceRows.count() || column < 0 || column >= columnCount())
+      return QModelIndex();
+
+   return createIndex(row, column);
+}
+
+QModelIndex CommitFilterProxyModel::parent(const QModelIndex &) const
+{
+   return QModelIndex();
+}
+
+int CommitFilterProxyModel::rowCount(const QModelIndex &parent) const
+{
+   return parent.isValid() ? 0 : mSourceRows.count();
+}
+
+int CommitFilterProxyModel::columnCount(const QModelIndex &parent) const
+{
+   return sourceModel() && !parent.isValid() ? sourceModel()->columnCount(QModelIndex()) : 0;
+}
+
+QModelIndex CommitFilterProxyModel::mapToSource(const QModelIndex &proxyIndex) const
+{
+   if (!sourceModel() || !proxyIndex.isValid() || proxyIndex.row() >= mSourceRows.count())
+      return QModelIndex();
+
+   return sourceModel()->index(mSourceRows.at(proxyIndex.row()), proxyIndex.column());
+}
+
+QModelIndex CommitFilterProxyModel::mapFromSource(const QModelIndex &sourceIndex) const
+{
+   if (!sourceIndex.isValid() || sourceIndex.row() >= mProxyRows.count())
+      return QModelIndex();
+
+   return index(mProxyRows.at(sourceIndex.row()), sourceIndex.column());
+}
+
+void CommitFilterProxyModel::refresh()
+{
+   mFilterFuture.cancel();
+   mIsFiltering = false;
+   mHasQueuedRows = false;
+   mFirstChangedRow = -1;
+   mLastChangedRow = -1;
+   ++mGeneration;
+
+   beginResetModel();
+   mSourceRows.clear();
+   mProxyRows.clear();
+   mLanes.clear();
+   endResetModel();
+
+   filterRows(0);
+}
+
+void CommitFilterProxyModel::filterRows(int firstRow)
+{
+   if (!sourceModel())
+      return;
+
+   mCommits = mCache->commits();
+
+   const auto count = qMin(sourceModel()->rowCount(), mCommits.count());
+
+   mProxyRows.resize(count);
+   std::fill(mProxyRows.begin() + firstRow, mProxyRows.end(), -1);
+
+   if (mMode == Mode::Commits)
+   {
+      QVector<int> rows;
+
+      for (const auto &id : qAsConst(mAcceptedCommits))
+      {
+         const auto row = mCommits.findRow(id);
+
+         if (row >= firstRow && row < count)
+            rows.append(row);
+      }
+
+      std::sort(rows.begin(), rows.end());
+      rows.erase(std::unique(rows.begin(), rows.end()), rows.end());
+
+      appendRows(rows);
+      computeLanes();
+
+      emit signalFilterFinished(mSourceRows.count());
+      return;
+   }
+
+   const auto generation = mGeneration;
+   const auto watcher = new QFutureWatcher<QVector<int>>(this);
+
+   mIsFiltering = true;
+   mNextChunk = 0;
+   mPendingChunks.clear();
+
+   connect(watcher, &QFutureWatcherBase::resultReadyAt, this, [this, watcher, generation](int chunk) {
+      if (generation != mGeneration)
+         return;
+
+      // The chunks finish in any order, but they are shown in the order of the history
+      mPendingChunks.insert(chunk, watcher->resultAt(chunk));
+
+      while (mPendingChunks.contains(mNextChunk))
+         appendRows(mPendingChunks.take(mNextChunk++));
+   });
+
+   connect(watcher, &QFutureWatcherBase::finished, this, [this, watcher, generation]() {
+      watcher->deleteLater();
+
+      if (generation != mGeneration)
+         return;
+
+      mIsFiltering = false;
+
+      if (mFirstChangedRow != -1)
+      {
+         updateRows(mFirstChangedRow, mLastChangedRow);
+
+         mFirstChangedRow = -1;
+         mLastChangedRow = -1;
+      }
+
+      // The pages that arrived meanwhile continue the filter, and the lanes wait until the whole history is done
+      if (mHasQueuedRows)
+      {
+         mHasQueuedRows = false;
+         filterRows(mProxyRows.count());
+         return;
+      }
+
+      QLog_Debug("UI", QString("The filter matches {%1} commits.").arg(mSourceRows.count()));
+
+      computeLanes();
+
+      emit signalFilterFinished(mSourceRows.count());
+   });
+
+   mFilterFuture = QtConcurrent::mapped(CommitFilterChunk::ranges(firstRow, count, FILTER_CHUNK_SIZE),
+                                        CommitFilterChunk(mCommits, mFilter));
+   watcher->setFuture(mFilterFuture);
+}
+
+void CommitFilterProxyModel::appendRows(const QVector<int> &sourceRows)
+{
+   if (sourceRows.isEmpty())
+      return;
+
+   const auto firstRow = mSourceRows.count();
+
+   beginInsertRows(QModelIndex(), firstRow, firstRow + sourceRows.count() - 1);
+
+   for (auto row : sourceRows)
+   {
+      mProxyRows[row] = mSourceRows.count();
+      mSourceRows.append(row);
+   }
+
+   endInsertRows();
+}
+
+bool CommitFilterProxyModel::updateRows(int firstRow, int lastRow)
+{
+   mCommits = mCache->commits();
+   lastRow = qMin(lastRow, qMin(mProxyRows.count(), mCommits.count()) - 1);
+
+   if (firstRow > lastRow)
+      return false;
+
+   // The source rows are sorted, so the ones of the range are a single block of the proxy
+   const auto begin
+       = static_cast<int>(std::lower_bound(mSourceRows.cbegin(), mSourceRows.cend(), firstRow) - mSourceRows.cbegin());
+   const auto end
+       = static_cast<int>(std::upper_bound(mSourceRows.cbegin(), mSourceRows.cend(), lastRow) - mSourceRows.cbegin());
+   const auto rows = CommitFilterChunk(mCommits, mFilter)(qMakePair(firstRow, lastRow + 1));
+
+   if (rows == mSourceRows.mid(begin, end - begin))
+      return false;
+
+   const auto updateProxyRows = [this](int firstProxyRow) {
+      for (auto proxyRow = firstProxyRow; proxyRow < mSourceRows.count(); ++proxyRow)
+         mProxyRows[mSourceRows.at(proxyRow)] = proxyRow;
+   };
+
+   // The lanes being computed belong to the previous rows
+   ++mGeneration;
+   mLanes.clear();
+
+   if (end > begin)
+   {
+      beginRemoveRows(QModelIndex(), begin, end - 1);
+
+      for (auto proxyRow = begin; proxyRow < end; ++proxyRow)
+         mProxyRows[mSourceRows.at(proxyRow)] = -1;
+
+      mSourceRows.remove(begin, end - begin);
+      updateProxyRows(begin);
+
+      endRemoveRows();
+   }
+
+   if (!rows.isEmpty())
+   {
+      beginInsertRows(QModelIndex(), begin, begin + rows.count() - 1);
+
+      for (auto i = 0; i < rows.count(); ++i)
+         mSourceRows.insert(begin + i, rows.at(i));
+
+      updateProxyRows(begin);
+
+      endInsertRows();
+   }
+
+   return true;
+}
+
+void CommitFilterProxyModel::computeLanes()
+{
+   if (mSourceRows.isEmpty())
+      return;
+
+   const auto generation = mGeneration;
+   const auto commits = mCommits;
+   const auto rows = mSourceRows;
+   const auto watcher = new QFutureWatcher<QVector<QVector<LaneType>>>(this);
+
+   connect(watcher, &QFutureWatcherBase::finished, this, [this, watcher, generation]() {
+      watcher->deleteLater();
+
+      if (generation != mGeneration || watcher->result().count() != mSourceRows.count())
+         return;
+
+      mLanes = watcher->result();
+
+      const auto graphColumn = static_cast<int>(CommitHistoryColumns::GRAPH);
+
+      emit dataChanged(index(0, graphColumn), index(mSourceRows.count() - 1, graphColumn));
+   });
+
+   watcher->setFuture(QtConcurrent::run([commits, rows]() { return GraphAlgorithms(commits).subsetLanes(rows); }));
+}
+
+void CommitFilterProxyModel::onSourceRowsInserted(const QModelIndex &, int first, int)
+{
+   // The next page of the history only needs its own rows filtered. Anything else moves the rows already shown.
+   if (first < mProxyRows.count())
+      refresh();
+   else if (mIsFiltering)
+      mHasQueuedRows = true;
+   else
+      filterRows(first);
+}
+
+void CommitFilterProxyModel::onSourceDataChanged(const QModelIndex &topLeft, const QModelIndex &bottomRight)
+{
+   const auto graphColumn = static_cast<int>(CommitHistoryColumns::GRAPH);
+
+   // The details of the commits arrive after the graph, so the rows they belong to are filtered again. The lanes of
+   // the history don't change what the filter matches.
+   if (mMode == Mode::Filter && (topLeft.column() != graphColumn || bottomRight.column() != graphColumn))
+   {
+      if (mIsFiltering)
+      {
+         mFirstChangedRow = mFirstChangedRow == -1 ? topLeft.row() : qMin(mFirstChangedRow, topLeft.row());
+         mLastChangedRow = qMax(mLastChangedRow, bottomRight.row());
+      }
+      else if (updateRows(topLeft.row(), bottomRight.row()))
+      {
+         computeLanes();
+
+         emit signalFilterFinished(mSourceRows.count());
+      }
+   }
+
+   const auto begin = std::lower_bound(mSourceRows.cbegin(), mSourceRows.cend(), topLeft.row());
+   const auto end = std::upper_bound(mSourceRows.cbegin(), mSourceRows.cend(), bottomRight.row());
+
+   if (begin != end)
+   {
+      const auto firstRow = static_cast<int>(begin - mSourceRows.cbegin());
+      const auto lastRow = static_cast<int>(end - mSourceRows.cbegin()) - 1;
+
+      emit dataChanged(index(firstRow, topLeft.column()), index(lastRow, bottomRight.column()));
+   }
+}
@@ -0,0 +1,106 @@
+#pragma once
+
+/****************************************************************************************
+ ** GitQlient is an application to manage and operate one or several Git repositories. With
+ ** GitQlient you will be able to add commits, branches and manage all the options Git provides.
+ ** Copyright (C) 2019  Francesc Martinez
+ **
+ ** LinkedIn: www.linkedin.com/in/cescmm/
+ ** Web: www.francescmm.com
+ **
+ ** This program is free software; you can redistribute it and/or
+ ** modify it under the terms of the GNU Lesser General Public
+ ** License as published by the Free Software Foundation; either
+ ** version 2 of the License, or (at your option) any later version.
+ **
+ ** This program is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ ** Lesser General Public License for more details.
+ **
+ ** You should have received a copy of the GNU Lesser General Public
+ ** License along with this library; if not, write to the Free Software
+ ** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ***************************************************************************************/
+
+#include <CommitFilter.h>
+#include <ObjectId.h>
+
+#include <QAbstractProxyModel>
+#include <QFuture>
+#include <QMap>
+#include <QSharedPointer>
+
+class RevisionsCache;
+enum class LaneType;
+
+// Proxy of the history that only shows some of its commits. The commits are either a given set of SHAs (the history
+// of a file) or the ones that match a CommitFilter. The rows of the history are kept sorted, so the mapping in both
+// directions is a lookup, and the filter runs in a worker thread: the matches are shown as they are found.
+//
+// Once the rows are known, the lanes of the filtered graph are computed in another worker, so the commits are drawn
+// linked to their nearest filtered ancestors.
+class CommitFilterProxyModel : public QAbstractProxyModel
+{
+   Q_OBJECT
+
+signals:
+   void signalFilterFinished(int matches);
+
+public:
+   explicit CommitFilterProxyModel(const QSharedPointer<RevisionsCache> &cache, QObject *parent = nullptr);
+
+   void setSourceModel(QAbstractItemModel *sourceModel) override;
+   void setAcceptedCommits(const QVector<ObjectId> &ids);
+   void setFilter(const CommitFilter &filter);
+   bool isFiltering() const { return mIsFiltering; }
+
+   // Returns false until the lanes of the filtered graph are ready
+   bool lanes(int proxyRow, QVector<LaneType> &lanes) const;
+
+   QModelIndex index(int row, int column, const QModelIndex &parent = QModelIndex()) const override;
+   QModelIndex parent(const QModelIndex &child) const override;
+   int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+   int columnCount(const QModelIndex &parent = QModelIndex()) const override;
+   QModelIndex mapToSource(const QModelIndex &proxyIndex) const override;
+   QModelIndex mapFromSource(const QModelIndex &sourceIndex) const override;
+
+private:
+   enum class Mode
+   {
+      Commits,
+      Filter
+   };
+
+   QSharedPointer<RevisionsCache> mCache;
+   Mode mMode = Mode::Commits;
+   QVector<ObjectId> mAcceptedCommits;
+   CommitFilter mFilter;
+
+   // Copy of the history the rows belong to, so the workers don't see the changes of the UI thread
+   CommitStore mCommits;
+   QVector<int> mSourceRows;
+   // Proxy row of each source row, -1 if it's filtered out
+   QVector<int> mProxyRows;
+   QVector<QVector<LaneType>> mLanes;
+
+   // Results of a previous filter are dropped when they arrive after a new one has started
+   int mGeneration = 0;
+   QFuture<QVector<int>> mFilterFuture;
+   bool mIsFiltering = false;
+   int mNextChunk = 0;
+   QMap<int, QVector<int>> mPendingChunks;
+   // Changes of the history that arrive while the filter runs, handled once it finishes
+   bool mHasQueuedRows = false;
+   int mFirstChangedRow = -1;
+   int mLastChangedRow = -1;
+
+   void refresh();
+   void filterRows(int firstRow);
+   void appendRows(const QVector<int> &sourceRows);
+   // Filters the rows again, returns true if the ones shown changed
+   bool updateRows(int firstRow, int lastRow);
+   void computeLanes();
+   void onSourceRowsInserted(const QModelIndex &parent, int first, int last);
+   void onSourceDataChanged(const QModelIndex &topLeft, const QModelIndex &bottomRight);
+};
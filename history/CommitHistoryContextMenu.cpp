@@ -74,34 +74,26 @@ void CommitHistoryContextMenu::createIndividualShaMenu()
 
          addBranchActions(sha);
 
-         QScopedPointer<GitBranches> git(new GitBranches(mGit));
-         const auto ret = git->getLastCommitOfBranch(mGit->getCurrentBranch());
-
-         if (ret.success)
+         // The WIP commit goes on top of the last commit of the current branch, so the cache already knows it
+         if (mCache->getCommitInfo(CommitInfo::ZERO_SHA).parent(0) == sha)
          {
-            const auto lastShaStr = ret.output.toString().remove('\n');
-
-            if (lastShaStr == sha)
-            {
-               const auto amendCommitAction = addAction("Amend");
-               connect(amendCommitAction, &QAction::triggered, this,
-                       [this]() { emit signalAmendCommit(mShas.first()); });
+            const auto amendCommitAction = addAction("Amend");
+            connect(amendCommitAction, &QAction::triggered, this, [this]() { emit signalAmendCommit(mShas.first()); });
 
-               const auto applyPatchAction = addAction("Apply patch");
-               connect(applyPatchAction, &QAction::triggered, this, &CommitHistoryContextMenu::applyPatch);
+            const auto applyPatchAction = addAction("Apply patch");
+            connect(applyPatchAction, &QAction::triggered, this, &CommitHistoryContextMenu::applyPatch);
 
-               const auto applyCommitAction = addAction("Apply commit");
-               connect(applyCommitAction, &QAction::triggered, this, &CommitHistoryContextMenu::applyCommit);
+            const auto applyCommitAction = addAction("Apply commit");
+            connect(applyCommitAction, &QAction::triggered, this, &CommitHistoryContextMenu::applyCommit);
 
-               const auto pushAction = addAction("Push");
-               connect(pushAction, &QAction::triggered, this, &CommitHistoryContextMenu::push);
+            const auto pushAction = addAction("Push");
+            connect(pushAction, &QAction::triggered, this, &CommitHistoryContextMenu::push);
 
-               const auto pullAction = addAction("Pull");
-               connect(pullAction, &QAction::triggered, this, &CommitHistoryContextMenu::pull);
+            const auto pullAction = addAction("Pull");
+            connect(pullAction, &QAction::triggered, this, &CommitHistoryContextMenu::pull);
 
-               const auto fetchAction = addAction("Fetch");
-               connect(fetchAction, &QAction::triggered, this, &CommitHistoryContextMenu::fetch);
-            }
+            const auto fetchAction = addAction("Fetch");
+            connect(fetchAction, &QAction::triggered, this, &CommitHistoryContextMenu::fetch);
          }
 
          const auto copyShaAction = addAction("Copy SHA");
@@ -359,8 +351,9 @@ void CommitHistoryContextMenu::merge(const QString &branchFrom)
 
 void CommitHistoryContextMenu::addBranchActions(const QString &sha)
 {
-   auto isCommitInCurrentBranch = false;
    const auto currentBranch = mGit->getCurrentBranch();
+   // Merging or cherry-picking makes no sense for the commits that are already in the current branch
+   auto isCommitInCurrentBranch = mCache->isAncestor(ObjectId::fromHex(sha), mCache->getHeadId());
    const auto remoteBranches = mCache->getRefNames(sha, RMT_BRANCH);
    const auto localBranches = mCache->getRefNames(sha, BRANCH);
    auto branches = localBranches;
@@ -7,11 +7,18 @@
 
 #include <QDateTime>
 
+namespace
+{
+// Rows whose texts are kept, a few screens of the history
+const int DISPLAY_ROWS_CACHE_SIZE = 1000;
+}
+
 CommitHistoryModel::CommitHistoryModel(const QSharedPointer<RevisionsCache> &cache, const QSharedPointer<GitBase> &git,
                                        QObject *p)
    : QAbstractItemModel(p)
    , mCache(cache)
    , mGit(git)
+   , mDisplayRows(DISPLAY_ROWS_CACHE_SIZE)
 {
    mColumns.insert(CommitHistoryColumns::GRAPH, "Graph");
    mColumns.insert(CommitHistoryColumns::ID, "Id");
@@ -39,13 +46,14 @@ bool CommitHistoryModel::hasChildren(const QModelIndex &parent) const
 
 QString CommitHistoryModel::sha(int row) const
 {
-   return index(row, static_cast<int>(CommitHistoryColumns::SHA)).data().toString();
+   return row >= 0 && row < rowCnt ? mCache->getCommitIdByRow(row).toHex() : QString();
 }
 
 void CommitHistoryModel::clear()
 {
    beginResetModel();
    curFNames.clear();
+   mDisplayRows.clear();
    rowCnt = 0;
    endResetModel();
    emit headerDataChanged(Qt::Horizontal, 0, 5);
@@ -60,9 +68,11 @@ void CommitHistoryModel::onNewRevisions(int totalCommits)
 
    // do not attempt to insert 0 rows since the inclusive range would be invalid
    const auto revisionsCount = totalCommits;
-   if (rowCnt == revisionsCount)
+   if (rowCnt >= revisionsCount)
    {
       beginResetModel();
+      mDisplayRows.clear();
+      rowCnt = revisionsCount;
       endResetModel();
       return;
    }
@@ -72,6 +82,41 @@ void CommitHistoryModel::onNewRevisions(int totalCommits)
    endInsertRows();
 }
 
+void CommitHistoryModel::onRevisionsAboutToBeInserted(int firstRow, int count)
+{
+   if (count > 0)
+      beginInsertRows(QModelIndex(), firstRow, firstRow + count - 1);
+}
+
+void CommitHistoryModel::onRevisionsInserted(int, int count)
+{
+   if (count > 0)
+   {
+      // The rows below the new ones move
+      mDisplayRows.clear();
+      rowCnt += count;
+
+      endInsertRows();
+   }
+
+   // The lanes of the rows below the new ones change, and the ones of the WIP commit when HEAD moves
+   if (rowCnt > 0)
+   {
+      const auto graphColumn = static_cast<int>(CommitHistoryColumns::GRAPH);
+
+      emit dataChanged(index(0, graphColumn), index(rowCnt - 1, graphColumn));
+   }
+}
+
+void CommitHistoryModel::onRevisionsUpdated(int firstRow, int lastRow)
+{
+   for (auto row = firstRow; row <= lastRow; ++row)
+      mDisplayRows.remove(row);
+
+   if (firstRow < rowCnt)
+      emit dataChanged(index(firstRow, 0), index(qMin(lastRow, rowCnt - 1), columnCount(QModelIndex()) - 1));
+}
+
 QVariant CommitHistoryModel::headerData(int section, Qt::Orientation orientation, int role) const
 {
    if (orientation == Qt::Horizontal && role == Qt::DisplayRole)
@@ -96,7 +141,7 @@ QModelIndex CommitHistoryModel::parent(const QModelIndex &) const
 QVariant CommitHistoryModel::getToolTipData(const CommitInfo &r) const
 {
    QString auxMessage;
-   const auto sha = r.sha();
+   const auto sha = r.id();
 
    if ((mCache->checkRef(sha) & CUR_BRANCH) && mGit->getCurrentBranch().isEmpty())
       auxMessage.append("<p>Status: <b>detached</b></p>");
@@ -119,46 +164,59 @@ QVariant CommitHistoryModel::getToolTipData(const CommitInfo &r) const
    QDateTime d;
    d.setSecsSinceEpoch(r.authorDate().toUInt());
 
-   return sha == CommitInfo::ZERO_SHA
+   return sha == CommitInfo::ZERO_ID
        ? QString()
        : QString("<p>%1 - %2<p></p>%3</p>%4")
-             .arg(r.author().split("<").first(), d.toString(Qt::SystemLocaleShortDate), sha, auxMessage);
+             .arg(r.author().split("<").first(), d.toString(Qt::SystemLocaleShortDate), r.sha(), auxMessage);
 }
 
-QVariant CommitHistoryModel::getDisplayData(const CommitInfo &rev, int column) const
+QVariant CommitHistoryModel::getDisplayData(const DisplayRow &row, int column) const
 {
    switch (static_cast<CommitHistoryColumns>(column))
    {
-      case CommitHistoryColumns::SHA: {
-         const auto sha = rev.sha();
-         return sha;
-      }
+      case CommitHistoryColumns::SHA:
+         return row.sha;
       case CommitHistoryColumns::LOG:
-         return rev.shortLog();
-      case CommitHistoryColumns::AUTHOR: {
-         const auto author = rev.author().split("<").first();
-         return author;
-      }
-      case CommitHistoryColumns::DATE: {
-         return QDateTime::fromSecsSinceEpoch(rev.authorDate().toUInt()).toString("dd MMM yyyy hh:mm");
-      }
+         return row.shortLog;
+      case CommitHistoryColumns::AUTHOR:
+         return row.author;
+      case CommitHistoryColumns::DATE:
+         return row.date;
       default:
          return QVariant();
    }
 }
 
+CommitHistoryModel::DisplayRow CommitHistoryModel::displayRow(int row) const
+{
+   if (const auto cachedRow = mDisplayRows.object(row))
+      return *cachedRow;
+
+   const auto rev = mCache->getCommitInfoByRow(row);
+
+   DisplayRow displayRow;
+   displayRow.sha = rev.sha();
+   displayRow.shortLog = rev.shortLog();
+   displayRow.author = rev.author().split("<").first();
+   displayRow.date = QDateTime::fromSecsSinceEpoch(rev.authorDate().toUInt()).toString("dd MMM yyyy hh:mm");
+
+   // The WIP changes with the working directory, without a signal for its row
+   if (rev.id() != CommitInfo::ZERO_ID)
+      mDisplayRows.insert(row, new DisplayRow(displayRow));
+
+   return displayRow;
+}
+
 QVariant CommitHistoryModel::data(const QModelIndex &index, int role) const
 {
    if (!index.isValid() || (role != Qt::DisplayRole && role != Qt::ToolTipRole))
       return QVariant();
 
-   const auto r = mCache->getCommitInfoByRow(index.row());
-
    if (role == Qt::ToolTipRole)
-      return getToolTipData(r);
+      return getToolTipData(mCache->getCommitInfoByRow(index.row()));
 
    if (role == Qt::DisplayRole)
-      return getDisplayData(r, index.column());
+      return getDisplayData(displayRow(index.row()), index.column());
 
    return QVariant();
 }
@@ -24,6 +24,7 @@
  ***************************************************************************************/
 
 #include <QAbstractItemModel>
+#include <QCache>
 #include <QSharedPointer>
 
 class RevisionsCache;
@@ -50,13 +51,28 @@ public:
    bool hasChildren(const QModelIndex &par = QModelIndex()) const override;
    int columnCount(const QModelIndex &) const override { return mColumns.count(); }
    void onNewRevisions(int totalCommits);
+   // The rows are inserted in the cache between both calls
+   void onRevisionsAboutToBeInserted(int firstRow, int count);
+   void onRevisionsInserted(int firstRow, int count);
+   void onRevisionsUpdated(int firstRow, int lastRow);
 
 private:
+   // Texts of the columns of a row, formatted once while the row is around the screen
+   struct DisplayRow
+   {
+      QString sha;
+      QString shortLog;
+      QString author;
+      QString date;
+   };
+
    QSharedPointer<RevisionsCache> mCache;
    QSharedPointer<GitBase> mGit;
+   mutable QCache<int, DisplayRow> mDisplayRows;
 
    QVariant getToolTipData(const CommitInfo &r) const;
-   QVariant getDisplayData(const CommitInfo &rev, int column) const;
+   QVariant getDisplayData(const DisplayRow &row, int column) const;
+   DisplayRow displayRow(int row) const;
 
    QMap<CommitHistoryColumns, QString> mColumns;
    int earlyOutputCnt = 0;
@@ -3,14 +3,16 @@
 #include <CommitHistoryModel.h>
 #include <CommitHistoryColumns.h>
 #include <CommitHistoryContextMenu.h>
-#include <ShaFilterProxyModel.h>
+#include <CommitFilterProxyModel.h>
 #include <GitBranches.h>
 #include <CommitInfo.h>
 #include <RevisionsCache.h>
 
 #include <QHeaderView>
+#include <QScrollBar>
 #include <QSettings>
 #include <QDateTime>
+#include <QSet>
 
 #include <QLogger.h>
 using namespace QLogger;
@@ -32,11 +34,15 @@ CommitHistoryView::CommitHistoryView(const QSharedPointer<RevisionsCache> &cache
 
    connect(header(), &QHeaderView::sectionResized, this, &CommitHistoryView::saveHeaderState);
    connect(this, &CommitHistoryView::customContextMenuRequested, this, &CommitHistoryView::showContextMenu);
+   connect(verticalScrollBar(), &QScrollBar::valueChanged, this, &CommitHistoryView::onScrolled);
 }
 
 void CommitHistoryView::setModel(QAbstractItemModel *model)
 {
-   mCommitHistoryModel = dynamic_cast<CommitHistoryModel *>(model);
+   // The history model is kept when the view moves to the proxy
+   if (const auto historyModel = dynamic_cast<CommitHistoryModel *>(model))
+      mCommitHistoryModel = historyModel;
+
    QTreeView::setModel(model);
    setupGeometry();
    connect(this->selectionModel(), &QItemSelectionModel::selectionChanged, this,
@@ -49,23 +55,68 @@ void CommitHistoryView::setModel(QAbstractItemModel *model)
 
 void CommitHistoryView::filterBySha(const QStringList &shaList)
 {
-   mIsFiltering = true;
+   QVector<ObjectId> ids;
+   ids.reserve(shaList.count());
+
+   for (const auto &sha : shaList)
+      ids.append(ObjectId::fromHex(sha));
+
+   mFiltersBySha = true;
+   mAcceptedCommits = ids;
 
-   if (mProxyModel)
+   setProxyModel();
+   mProxyModel->setAcceptedCommits(ids);
+}
+
+void CommitHistoryView::filterCommits(const CommitFilter &filter)
+{
+   if (filter.isEmpty())
    {
-      mProxyModel->beginResetModel();
-      mProxyModel->setAcceptedSha(shaList);
-      mProxyModel->endResetModel();
+      if (mFiltersBySha)
+      {
+         setProxyModel();
+         mProxyModel->setAcceptedCommits(mAcceptedCommits);
+      }
+      else if (mIsFiltering)
+      {
+         mIsFiltering = false;
+         setModel(mCommitHistoryModel);
+
+         // The proxy stays connected to the history, so it must not keep filtering it
+         mProxyModel->setAcceptedCommits({});
+      }
    }
    else
    {
-      mProxyModel = new ShaFilterProxyModel(this);
+      setProxyModel();
+      mProxyModel->setFilter(filter);
+   }
+}
+
+void CommitHistoryView::setProxyModel()
+{
+   mIsFiltering = true;
+
+   if (!mProxyModel)
+   {
+      mProxyModel = new CommitFilterProxyModel(mCache, this);
       mProxyModel->setSourceModel(mCommitHistoryModel);
-      mProxyModel->setAcceptedSha(shaList);
-      setModel(mProxyModel);
+      connect(mProxyModel, &CommitFilterProxyModel::signalFilterFinished, this,
+              &CommitHistoryView::signalFilterFinished);
    }
 
-   setupGeometry();
+   if (model() != mProxyModel)
+      setModel(mProxyModel);
+}
+
+int CommitHistoryView::sourceRow(const QModelIndex &index) const
+{
+   return mIsFiltering && mProxyModel ? mProxyModel->mapToSource(index).row() : index.row();
+}
+
+bool CommitHistoryView::getFilteredLanes(const QModelIndex &index, QVector<LaneType> &lanes) const
+{
+   return mIsFiltering && mProxyModel && mProxyModel->lanes(index.row(), lanes);
 }
 
 CommitHistoryView::~CommitHistoryView()
@@ -108,9 +159,25 @@ void CommitHistoryView::currentChanged(const QModelIndex &index, const QModelInd
 
 void CommitHistoryView::clear()
 {
+   mHighlightedCommits.clear();
    mCommitHistoryModel->clear();
 }
 
+void CommitHistoryView::setHighlightedCommits(const QSet<ObjectId> &ids)
+{
+   mHighlightedCommits = ids;
+
+   viewport()->update();
+}
+
+bool CommitHistoryView::isHighlighted(const QModelIndex &index) const
+{
+   if (mHighlightedCommits.isEmpty())
+      return false;
+
+   return mHighlightedCommits.contains(mCache->getCommitIdByRow(sourceRow(index)));
+}
+
 void CommitHistoryView::focusOnCommit(const QString &goToSha)
 {
    mCurrentSha = goToSha;
@@ -159,6 +226,34 @@ void CommitHistoryView::showContextMenu(const QPoint &pos)
    }
 }
 
+void CommitHistoryView::onScrolled(int value)
+{
+   // The next page of the history is requested when the last screen of commits is reached
+   const auto scrollBar = verticalScrollBar();
+
+   if (value >= scrollBar->maximum() - scrollBar->pageStep())
+      emit signalLoadMoreCommits();
+
+   const auto firstIndex = indexAt(viewport()->rect().topLeft());
+   const auto lastIndex = indexAt(viewport()->rect().bottomLeft());
+
+   if (firstIndex.isValid())
+      emit signalDetailsRequested(sourceRow(firstIndex),
+                                  lastIndex.isValid() ? sourceRow(lastIndex) : mCache->count() - 1);
+}
+
+void CommitHistoryView::fillViewport()
+{
+   // A hidden view has no size, so it would request the whole history
+   if (!isVisible())
+      return;
+
+   // The scroll bar range is updated with the rows layout, that is delayed until the next event loop
+   executeDelayedItemsLayout();
+
+   onScrolled(verticalScrollBar()->value());
+}
+
 void CommitHistoryView::saveHeaderState()
 {
    QSettings s;
@@ -169,41 +264,50 @@ QList<QString> CommitHistoryView::getSelectedShaList() const
 {
    const auto indexes = selectedIndexes();
    QMap<QDateTime, QString> shas;
-   QVector<QVector<QString>> godVector;
+   QSet<int> rows;
+   QSet<QString> commonBranches;
 
    for (auto index : indexes)
    {
-      const auto sha = mCommitHistoryModel->sha(index.row());
+      // There is one index per column
+      if (rows.contains(index.row()))
+         continue;
+
+      const auto row = sourceRow(index);
+      const auto sha = mCommitHistoryModel->sha(row);
       const auto dtStr
-          = mCommitHistoryModel->index(index.row(), static_cast<int>(CommitHistoryColumns::DATE)).data().toString();
+          = mCommitHistoryModel->index(row, static_cast<int>(CommitHistoryColumns::DATE)).data().toString();
       const auto dt = QDateTime::fromString(dtStr, "dd MMM yyyy hh:mm");
 
       shas.insert(dt, sha);
-      QScopedPointer<GitBranches> git(new GitBranches(mGit));
-      const auto ret = git->getBranchesOfCommit(sha);
 
-      auto branches = ret.output.toString().trimmed().split("\n ");
-      std::sort(branches.begin(), branches.end());
-      godVector.append(branches.toVector());
+      const auto branches = getBranchesOfCommit(sha);
+      commonBranches = rows.isEmpty() ? branches : commonBranches.intersect(branches);
+      rows.insert(index.row());
    }
 
-   auto commitsInSameBranch = false;
+   return !commonBranches.isEmpty() || shas.count() == 1 ? shas.values() : QList<QString>();
+}
+
+QSet<QString> CommitHistoryView::getBranchesOfCommit(const QString &sha) const
+{
+   QStringList branches;
 
-   if (godVector.count() > 1)
+   // Git is asked only when some branch is not loaded (e.g. when only the current branch is shown)
+   if (!mCache->getBranchesContaining(ObjectId::fromHex(sha), branches))
    {
-      QVector<QString> common;
+      const auto ret = GitBranches(mGit).getBranchesOfCommit(sha);
 
-      for (auto i = 0; i < godVector.count() - 1; ++i)
+      branches.clear();
+
+      for (auto branch : ret.output.toString().split('\n', QString::SkipEmptyParts))
       {
-         QVector<QString> aux;
-         std::set_intersection(godVector.at(i).constBegin(), godVector.at(i).constEnd(),
-                               godVector.at(i + 1).constBegin(), godVector.at(i + 1).constEnd(),
-                               std::back_inserter(aux));
-         common = aux;
-      }
+         branch = branch.mid(2).trimmed();
 
-      commitsInSameBranch = !common.isEmpty();
+         if (!branch.contains(" -> "))
+            branches.append(branch.startsWith("remotes/") ? branch.mid(8) : branch);
+      }
    }
 
-   return commitsInSameBranch || shas.count() == 1 ? shas.values() : QList<QString>();
+   return branches.toSet();
 }
@@ -23,12 +23,17 @@
  ** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
  ***************************************************************************************/
 
+#include <ObjectId.h>
+
+#include <QSet>
 #include <QTreeView>
 
 class RevisionsCache;
 class GitBase;
 class CommitHistoryModel;
-class ShaFilterProxyModel;
+class CommitFilterProxyModel;
+struct CommitFilter;
+enum class LaneType;
 
 class CommitHistoryView : public QTreeView
 {
@@ -39,6 +44,10 @@ signals:
    void signalOpenDiff(const QString &sha);
    void signalOpenCompareDiff(const QStringList &sha);
    void signalAmendCommit(const QString &sha);
+   void signalLoadMoreCommits();
+   // Rows of the history that are shown, so their details can be loaded first
+   void signalDetailsRequested(int firstRow, int lastRow);
+   void signalFilterFinished(int matches);
 
 public:
    explicit CommitHistoryView(const QSharedPointer<RevisionsCache> &cache, const QSharedPointer<GitBase> &git,
@@ -48,23 +57,41 @@ public:
    void setModel(QAbstractItemModel *model) override;
    QList<QString> getSelectedShaList() const;
    void filterBySha(const QStringList &shaList);
+   // An empty filter shows the whole history again, or the commits given to filterBySha if any
+   void filterCommits(const CommitFilter &filter);
    void activateFilter(bool activate) { mIsFiltering = activate; }
    bool hasActiveFilter() const { return mIsFiltering; }
+   // Row of the history shown in the index, that is different when there is a filter
+   int sourceRow(const QModelIndex &index) const;
+   // Returns false until the lanes of the filtered graph are ready
+   bool getFilteredLanes(const QModelIndex &index, QVector<LaneType> &lanes) const;
 
    void clear();
    void focusOnCommit(const QString &goToSha);
+   // The commits found by the search are painted highlighted
+   void setHighlightedCommits(const QSet<ObjectId> &ids);
+   bool isHighlighted(const QModelIndex &index) const;
    QString getCurrentSha() const { return mCurrentSha; }
    QModelIndexList selectedIndexes() const override;
+   // Requests more commits when the loaded ones don't fill the view, since there is nothing to scroll then
+   void fillViewport();
 
 private:
    QSharedPointer<RevisionsCache> mCache;
    QSharedPointer<GitBase> mGit;
    CommitHistoryModel *mCommitHistoryModel = nullptr;
-   ShaFilterProxyModel *mProxyModel = nullptr;
+   CommitFilterProxyModel *mProxyModel = nullptr;
    bool mIsFiltering = false;
+   // Commits of the file history, shown again when the filter is cleared
+   bool mFiltersBySha = false;
+   QVector<ObjectId> mAcceptedCommits;
    QString mCurrentSha;
+   QSet<ObjectId> mHighlightedCommits;
 
+   void setProxyModel();
    void showContextMenu(const QPoint &);
+   QSet<QString> getBranchesOfCommit(const QString &sha) const;
+   void onScrolled(int value);
    void saveHeaderState();
    void setupGeometry();
    void currentChanged(const QModelIndex &, const QModelIndex &) override;
@@ -1,16 +1,20 @@
 INCLUDEPATH += $$PWD
 
 HEADERS += \
+    $$PWD/CommitFilterBar.h \
+    $$PWD/CommitFilterProxyModel.h \
     $$PWD/CommitHistoryColumns.h \
     $$PWD/CommitHistoryContextMenu.h \
     $$PWD/CommitHistoryModel.h \
     $$PWD/CommitHistoryView.h \
-    $$PWD/RepositoryViewDelegate.h \
-    $$PWD/ShaFilterProxyModel.h
+    $$PWD/RefDecorations.h \
+    $$PWD/RepositoryViewDelegate.h
 
 SOURCES += \
+    $$PWD/CommitFilterBar.cpp \
+    $$PWD/CommitFilterProxyModel.cpp \
     $$PWD/CommitHistoryContextMenu.cpp \
     $$PWD/CommitHistoryModel.cpp \
     $$PWD/CommitHistoryView.cpp \
-    $$PWD/RepositoryViewDelegate.cpp \
-    $$PWD/ShaFilterProxyModel.cpp
+    $$PWD/RefDecorations.cpp \
+    $$PWD/RepositoryViewDelegate.cpp
@@ -0,0 +1,91 @@
+#include "RefDecorations.h"
+
+#include <GitQlientStyles.h>
+#include <Reference.h>
+
+#include <QFont>
+#include <QFontMetrics>
+#include <QMap>
+
+const QString RefDecorations::MINIMAL_NAME = QString(". . .");
+
+namespace
+{
+// Brightness of the pill color above which the white text isn't readable
+const int LIGHT_COLOR_THRESHOLD = 160;
+
+QColor textColor(const QColor &pillColor)
+{
+   return qGray(pillColor.rgb()) > LIGHT_COLOR_THRESHOLD ? QColor(Qt::black) : QColor(Qt::white);
+}
+}
+
+void RefDecorations::build(const QHash<ObjectId, Reference> &references, const QString &currentBranch,
+                           const QFont &font)
+{
+   mPills.clear();
+
+   auto boldFont = font;
+   boldFont.setBold(true);
+
+   const QFontMetrics fm(font);
+   const QFontMetrics boldFm(boldFont);
+   const auto isDetached = currentBranch.isEmpty() || currentBranch == "HEAD";
+
+   for (auto iter = references.cbegin(); iter != references.cend(); ++iter)
+   {
+      const auto &ref = iter.value();
+
+      if (!ref.isValid())
+         continue;
+
+      // Sorted by name as they are painted
+      QMap<QString, QColor> markValues;
+
+      if (ref.type & CUR_BRANCH && isDetached)
+         markValues.insert("detached", GitQlientStyles::getDetachedColor());
+
+      for (const auto &branch : ref.branches)
+      {
+         markValues.insert(branch,
+                           branch == currentBranch ? GitQlientStyles::getCurrentBranchColor()
+                                                   : GitQlientStyles::getLocalBranchColor());
+      }
+
+      for (const auto &branch : ref.remoteBranches)
+         markValues.insert(branch, QColor("#011f4b"));
+
+      for (const auto &tag : ref.tags)
+         markValues.insert(tag, GitQlientStyles::getTagColor());
+
+      for (const auto &name : ref.refs)
+         markValues.insert(name, GitQlientStyles::getRefsColor());
+
+      if (markValues.isEmpty())
+         continue;
+
+      QVector<Pill> pills;
+      pills.reserve(markValues.count());
+
+      for (auto mapIt = markValues.constBegin(); mapIt != markValues.constEnd(); ++mapIt)
+      {
+         Pill pill;
+         pill.name = mapIt.key();
+         pill.color = mapIt.value();
+         pill.textColor = textColor(pill.color);
+         pill.isCurrent = pill.name == "detached" || pill.name == currentBranch;
+
+         const auto &metrics = pill.isCurrent ? boldFm : fm;
+         const auto textBoundingRect = metrics.boundingRect(pill.name);
+         const auto minimalBoundingRect = metrics.boundingRect(MINIMAL_NAME);
+         pill.width = textBoundingRect.width();
+         pill.height = textBoundingRect.height();
+         pill.minimalWidth = minimalBoundingRect.width();
+         pill.minimalHeight = minimalBoundingRect.height();
+
+         pills.append(pill);
+      }
+
+      mPills.insert(iter.key(), pills);
+   }
+}
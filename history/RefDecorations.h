@@ -0,0 +1,63 @@
+#pragma once
+
+/****************************************************************************************
+ ** GitQlient is an application to manage and operate one or several Git repositories. With
+ ** GitQlient you will be able to add commits, branches and manage all the options Git provides.
+ ** Copyright (C) 2019  Francesc Martinez
+ **
+ ** LinkedIn: www.linkedin.com/in/cescmm/
+ ** Web: www.francescmm.com
+ **
+ ** This program is free software; you can redistribute it and/or
+ ** modify it under the terms of the GNU Lesser General Public
+ ** License as published by the Free Software Foundation; either
+ ** version 2 of the License, or (at your option) any later version.
+ **
+ ** This program is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ ** Lesser General Public License for more details.
+ **
+ ** You should have received a copy of the GNU Lesser General Public
+ ** License along with this library; if not, write to the Free Software
+ ** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ***************************************************************************************/
+
+#include <ObjectId.h>
+
+#include <QColor>
+#include <QHash>
+#include <QString>
+#include <QVector>
+
+class QFont;
+struct Reference;
+
+// Pills painted before the summary of the commits that have references: branches, tags, etc. The table is built once
+// per change of the references, with the texts already measured, so painting a row is a lookup of its commit.
+class RefDecorations
+{
+public:
+   struct Pill
+   {
+      QString name;
+      QColor color;
+      QColor textColor;
+      // The current branch, or the detached HEAD, is painted in bold
+      bool isCurrent = false;
+      int width = 0;
+      // Width of the text shown when the view is too narrow for the names
+      int minimalWidth = 0;
+      int height = 0;
+      int minimalHeight = 0;
+   };
+
+   static const QString MINIMAL_NAME;
+
+   void build(const QHash<ObjectId, Reference> &references, const QString &currentBranch, const QFont &font);
+   void clear() { mPills.clear(); }
+   QVector<Pill> pills(const ObjectId &sha) const { return mPills.value(sha); }
+
+private:
+   QHash<ObjectId, QVector<Pill>> mPills;
+};
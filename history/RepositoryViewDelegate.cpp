@@ -9,16 +9,21 @@
 #include <RevisionsCache.h>
 #include <GitBase.h>
 
-#include <QSortFilterProxyModel>
 #include <QPainter>
 
 static const int MIN_VIEW_WIDTH_PX = 480;
+static const int ELIDED_TEXTS_CACHE_SIZE = 4000;
+// Lane glyphs are a lane wide plus a margin for the pen and the lines that reach the next lane
+static const int GLYPH_MARGIN = 4;
+static const int GLYPHS_CACHE_SIZE = 4096;
 
 RepositoryViewDelegate::RepositoryViewDelegate(const QSharedPointer<RevisionsCache> &cache,
                                                const QSharedPointer<GitBase> &git, CommitHistoryView *view)
    : mCache(cache)
    , mGit(git)
    , mView(view)
+   , mElidedTexts(ELIDED_TEXTS_CACHE_SIZE)
+   , mGlyphs(GLYPHS_CACHE_SIZE)
 {
 }
 
@@ -26,8 +31,10 @@ void RepositoryViewDelegate::paint(QPainter *p, const QStyleOptionViewItem &opt,
 {
    p->setRenderHints(QPainter::Antialiasing);
 
+   updateFonts(opt.font);
+
    QStyleOptionViewItem newOpt(opt);
-   newOpt.font.setPointSize(9);
+   newOpt.font = mFont;
 
    if (newOpt.state & QStyle::State_Selected)
    {
@@ -41,6 +48,12 @@ void RepositoryViewDelegate::paint(QPainter *p, const QStyleOptionViewItem &opt,
       c.setAlphaF(0.4);
       p->fillRect(newOpt.rect, c);
    }
+   else if (mView->isHighlighted(index))
+   {
+      auto c = GitQlientStyles::getOrange();
+      c.setAlphaF(0.2);
+      p->fillRect(newOpt.rect, c);
+   }
 
    if (index.column() == static_cast<int>(CommitHistoryColumns::GRAPH))
       paintGraph(p, newOpt, index);
@@ -52,18 +65,11 @@ void RepositoryViewDelegate::paint(QPainter *p, const QStyleOptionViewItem &opt,
       p->setPen(GitQlientStyles::getTextColor());
       newOpt.rect.setX(newOpt.rect.x() + 10);
 
-      auto text = index.data().toString();
-
       if (index.column() == static_cast<int>(CommitHistoryColumns::SHA))
-      {
-         newOpt.font.setPointSize(10);
-         newOpt.font.setFamily("Ubuntu Mono");
-         text = text.left(8);
-      }
+         newOpt.font = mShaFont;
 
-      QFontMetrics fm(newOpt.font);
       p->setFont(newOpt.font);
-      p->drawText(newOpt.rect, fm.elidedText(text, Qt::ElideRight, newOpt.rect.width()),
+      p->drawText(newOpt.rect, elidedText(index, index.data().toString(), newOpt.font, newOpt.rect.width()),
                   QTextOption(Qt::AlignLeft | Qt::AlignVCenter));
    }
 }
@@ -85,7 +91,7 @@ void RepositoryViewDelegate::paintGraphLane(QPainter *p, LaneType type, bool lan
    const auto angleHeightUp = 2 * h;
    const auto angleHeightDown = 2 * -h;
 
-   static QPen lanePen(GitQlientStyles::getTextColor(), 2); // fast path here
+   QPen lanePen(GitQlientStyles::getTextColor(), 2);
 
    // arc
    lanePen.setBrush(col);
@@ -208,24 +214,36 @@ void RepositoryViewDelegate::paintGraphLane(QPainter *p, LaneType type, bool lan
 
 void RepositoryViewDelegate::paintGraph(QPainter *p, const QStyleOptionViewItem &opt, const QModelIndex &index) const
 {
-   const auto row = mView->hasActiveFilter()
-       ? dynamic_cast<QSortFilterProxyModel *>(mView->model())->mapToSource(index).row()
-       : index.row();
-
-   const auto r = mCache->getCommitInfoByRow(row);
+   const auto row = mView->sourceRow(index);
+   const auto id = mCache->getCommitIdByRow(row);
 
-   if (r.sha().isEmpty())
+   if (id.isNull())
       return;
 
+   const auto isWip = id == CommitInfo::ZERO_ID;
+
    p->save();
    p->setClipRect(opt.rect, Qt::IntersectClip);
    p->translate(opt.rect.topLeft());
 
-   const QVector<LaneType> &lanes(r.lanes);
+   // The lanes of every row are decoded into the same vector
+   auto &lanes = mLanes;
+   auto isSingleNode = false;
+
+   // The filtered graph has its own lanes, so the ones of the whole history are not replayed. Until they are ready, the
+   // commits are drawn alone.
+   if (!mView->hasActiveFilter())
+      mCache->getLanes(row, lanes);
+   else if (!mView->getFilteredLanes(index, lanes))
+   {
+      isSingleNode = true;
+      lanes.fill(LaneType::ACTIVE, 1);
+   }
+
    auto laneNum = lanes.count();
    auto activeLane = 0;
 
-   for (int i = 0; i < laneNum && !mView->hasActiveFilter(); i++)
+   for (int i = 0; i < laneNum && !isSingleNode; i++)
    {
       if (isActive(lanes[i]))
       {
@@ -252,14 +270,14 @@ void RepositoryViewDelegate::paintGraph(QPainter *p, const QStyleOptionViewItem
 
       x1 = x2 - LANE_WIDTH;
 
-      auto ln = mView->hasActiveFilter() ? LaneType::ACTIVE : lanes[i];
+      auto ln = isSingleNode ? LaneType::ACTIVE : lanes[i];
 
       if (ln != LaneType::EMPTY)
       {
          QColor color;
          if (i == activeLane)
          {
-            if (r.sha() == CommitInfo::ZERO_SHA && !mCache->pendingLocalChanges())
+            if (isWip && !mCache->pendingLocalChanges())
                color = QColor("#D89000");
             else
                color = activeColor;
@@ -299,102 +317,155 @@ void RepositoryViewDelegate::paintGraph(QPainter *p, const QStyleOptionViewItem
             default:
                break;
          }
-         paintGraphLane(p, ln, laneHeadPresent, x1, x2, color, activeColor, back, r.sha() == CommitInfo::ZERO_SHA);
+         drawGraphLane(p, ln, laneHeadPresent, x1, color, activeColor, back, isWip);
 
-         if (mView->hasActiveFilter())
+         if (isSingleNode)
             break;
       }
    }
    p->restore();
 }
 
+void RepositoryViewDelegate::drawGraphLane(QPainter *p, LaneType type, bool laneHeadPresent, int x1, const QColor &col,
+                                           const QColor &activeCol, const QColor &mergeColor, bool isWip) const
+{
+   const auto devicePixelRatio = p->device()->devicePixelRatioF();
+   const GlyphKey key { type, laneHeadPresent, isWip, col.rgba(), activeCol.rgba(), mergeColor.rgba(),
+                        devicePixelRatio };
+   auto glyph = mGlyphs.object(key);
+
+   if (!glyph)
+   {
+      glyph = new QPixmap(QSize(LANE_WIDTH + 2 * GLYPH_MARGIN, ROW_HEIGHT) * devicePixelRatio);
+      glyph->setDevicePixelRatio(devicePixelRatio);
+      glyph->fill(Qt::transparent);
+
+      QPainter glyphPainter(glyph);
+      glyphPainter.setRenderHints(QPainter::Antialiasing);
+      paintGraphLane(&glyphPainter, type, laneHeadPresent, GLYPH_MARGIN, GLYPH_MARGIN + LANE_WIDTH, col, activeCol,
+                     mergeColor, isWip);
+      glyphPainter.end();
+
+      mGlyphs.insert(key, glyph);
+   }
+
+   p->drawPixmap(x1 - GLYPH_MARGIN, 0, *glyph);
+}
+
 void RepositoryViewDelegate::paintLog(QPainter *p, const QStyleOptionViewItem &opt, const QModelIndex &index) const
 {
-   const auto sha = mCache->getCommitInfoByRow(index.row()).sha();
+   const auto sha = mCache->getCommitIdByRow(mView->sourceRow(index));
 
-   if (sha.isEmpty())
+   if (sha.isNull())
       return;
 
    auto offset = 0;
 
-   if (mCache->checkRef(sha) > 0 && !mView->hasActiveFilter())
+   if (!mView->hasActiveFilter())
    {
-      offset = 5;
-      paintTagBranch(p, opt, offset, sha);
+      const auto pills = decorations().pills(sha);
+
+      if (!pills.isEmpty())
+      {
+         offset = 5;
+         paintTagBranch(p, opt, offset, pills);
+      }
    }
 
    auto newOpt = opt;
    newOpt.rect.setX(opt.rect.x() + offset + 5);
 
-   QFontMetrics fm(newOpt.font);
-
    p->setFont(newOpt.font);
    p->setPen(GitQlientStyles::getTextColor());
-   p->drawText(newOpt.rect, fm.elidedText(index.data().toString(), Qt::ElideRight, newOpt.rect.width()),
+   p->drawText(newOpt.rect, elidedText(index, index.data().toString(), newOpt.font, newOpt.rect.width()),
                QTextOption(Qt::AlignLeft | Qt::AlignVCenter));
 }
 
-void RepositoryViewDelegate::paintTagBranch(QPainter *painter, QStyleOptionViewItem o, int &startPoint,
-                                            const QString &sha) const
+void RepositoryViewDelegate::updateFonts(const QFont &viewFont) const
+{
+   if (mAreFontsSet && viewFont == mViewFont)
+      return;
+
+   mAreFontsSet = true;
+   mViewFont = viewFont;
+
+   mFont = viewFont;
+   mFont.setPointSize(9);
+
+   mShaFont = mFont;
+   mShaFont.setPointSize(10);
+   mShaFont.setFamily("Ubuntu Mono");
+
+   mBoldFont = mFont;
+   mBoldFont.setBold(true);
+
+   // The widths of all the texts change with the font
+   mElidedTexts.clear();
+   mDecorationsRevision = -1;
+}
+
+QString RepositoryViewDelegate::elidedText(const QModelIndex &index, const QString &text, const QFont &font,
+                                           int width) const
 {
-   QMap<QString, QColor> markValues;
-   auto ref_types = mCache->checkRef(sha);
-   const auto currentBranch = mGit->getCurrentBranch();
+   // The rows of the history are the key, so they are still valid when the filter changes
+   const auto key = qMakePair(mView->sourceRow(index), index.column());
+   const auto cached = mElidedTexts.object(key);
 
-   if (ref_types != 0)
+   // The width changes when the column or the view is resized
+   if (cached && cached->width == width && cached->text == text)
+      return cached->elided;
+
+   const auto isSha = index.column() == static_cast<int>(CommitHistoryColumns::SHA);
+   const auto entry = new ElidedText();
+   entry->text = text;
+   entry->width = width;
+   entry->elided = QFontMetrics(font).elidedText(isSha ? text.left(8) : text, Qt::ElideRight, width);
+
+   const auto elided = entry->elided;
+   mElidedTexts.insert(key, entry);
+
+   return elided;
+}
+
+const RefDecorations &RepositoryViewDelegate::decorations() const
+{
+   const auto revision = mCache->getReferencesRevision();
+
+   if (revision != mDecorationsRevision)
    {
-      if (ref_types & CUR_BRANCH && (currentBranch.isEmpty() || currentBranch == "HEAD"))
-         markValues.insert("detached", GitQlientStyles::getDetachedColor());
-
-      const auto localBranches = mCache->getRefNames(sha, BRANCH);
-      for (const auto &branch : localBranches)
-         markValues.insert(branch,
-                           branch == currentBranch ? GitQlientStyles::getCurrentBranchColor()
-                                                   : GitQlientStyles::getLocalBranchColor());
-
-      const auto remoteBranches = mCache->getRefNames(sha, RMT_BRANCH);
-      for (const auto &branch : remoteBranches)
-         markValues.insert(branch, QColor("#011f4b"));
-
-      const auto tags = mCache->getRefNames(sha, TAG);
-      for (const auto &tag : tags)
-         markValues.insert(tag, GitQlientStyles::getTagColor());
-
-      const auto refs = mCache->getRefNames(sha, REF);
-      for (const auto &ref : refs)
-         markValues.insert(ref, GitQlientStyles::getRefsColor());
+      mDecorations.build(mCache->getReferences(), mGit->getCurrentBranch(), mFont);
+      mDecorationsRevision = revision;
    }
 
+   return mDecorations;
+}
+
+void RepositoryViewDelegate::paintTagBranch(QPainter *painter, const QStyleOptionViewItem &o, int &startPoint,
+                                            const QVector<RefDecorations::Pill> &pills) const
+{
    const auto showMinimal = o.rect.width() <= MIN_VIEW_WIDTH_PX;
    const int mark_spacing = 5; // Space between markers in pixels
-   const auto mapEnd = markValues.constEnd();
+   const int textPadding = 3;
 
-   for (auto mapIt = markValues.constBegin(); mapIt != mapEnd; ++mapIt)
+   for (const auto &pill : pills)
    {
-      const auto isCurrentSpot = mapIt.key() == "detached" || mapIt.key() == currentBranch;
-      o.font.setBold(isCurrentSpot);
-
-      const auto nameToDisplay = showMinimal ? QString(". . .") : mapIt.key();
-      QFontMetrics fm(o.font);
-      const auto textBoundingRect = fm.boundingRect(nameToDisplay);
-      const int textPadding = 3;
-      const auto rectWidth = textBoundingRect.width() + 2 * textPadding;
+      const auto rectWidth = (showMinimal ? pill.minimalWidth : pill.width) + 2 * textPadding;
 
       painter->save();
       painter->setRenderHint(QPainter::Antialiasing);
-      painter->setPen(QPen(mapIt.value(), 2));
+      painter->setPen(QPen(pill.color, 2));
       QPainterPath path;
       path.addRoundedRect(QRectF(o.rect.x() + startPoint, o.rect.y() + 4, rectWidth, ROW_HEIGHT - 8), 1, 1);
-      painter->fillPath(path, mapIt.value());
+      painter->fillPath(path, pill.color);
       painter->drawPath(path);
 
-      // TODO: Fix this with a nicer way
-      painter->setPen(QColor(mapIt.value() == QColor("#dec3c3") ? QString("#000000") : QString("#FFFFFF")));
+      painter->setPen(pill.textColor);
 
-      const auto fontRect = textBoundingRect.height();
+      const auto fontRect = showMinimal ? pill.minimalHeight : pill.height;
       const auto y = o.rect.y() + ROW_HEIGHT - (ROW_HEIGHT - fontRect) + 2;
-      painter->setFont(o.font);
-      painter->drawText(o.rect.x() + startPoint + textPadding, y, nameToDisplay);
+      painter->setFont(pill.isCurrent ? mBoldFont : o.font);
+      painter->drawText(o.rect.x() + startPoint + textPadding, y,
+                        showMinimal ? RefDecorations::MINIMAL_NAME : pill.name);
       painter->restore();
 
       startPoint += rectWidth + mark_spacing;
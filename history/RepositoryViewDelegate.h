@@ -23,6 +23,10 @@
  ** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
  ***************************************************************************************/
 
+#include <RefDecorations.h>
+
+#include <QCache>
+#include <QPixmap>
 #include <QStyledItemDelegate>
 
 class CommitHistoryView;
@@ -49,14 +53,65 @@ public:
    }
 
 private:
+   // Pre-rasterized lane of the graph. The glyphs are painted with antialiasing once and then blitted in every row.
+   struct GlyphKey
+   {
+      LaneType type;
+      bool laneHeadPresent;
+      bool isWip;
+      QRgb color;
+      QRgb activeColor;
+      QRgb mergeColor;
+      qreal devicePixelRatio;
+
+      bool operator==(const GlyphKey &key) const
+      {
+         return type == key.type && laneHeadPresent == key.laneHeadPresent && isWip == key.isWip
+             && color == key.color && activeColor == key.activeColor && mergeColor == key.mergeColor
+             && qFuzzyCompare(devicePixelRatio, key.devicePixelRatio);
+      }
+
+      friend uint qHash(const GlyphKey &key, uint seed = 0)
+      {
+         return qHash(static_cast<int>(key.type), seed) ^ qHash(key.color, seed) ^ qHash(key.activeColor, seed + 1)
+             ^ qHash(key.mergeColor, seed + 2) ^ (key.laneHeadPresent ? 0x100 : 0) ^ (key.isWip ? 0x200 : 0);
+      }
+   };
+
+   // Text of a cell elided to the width it was painted with
+   struct ElidedText
+   {
+      QString text;
+      int width = 0;
+      QString elided;
+   };
+
    QSharedPointer<RevisionsCache> mCache;
    QSharedPointer<GitBase> mGit;
    CommitHistoryView *mView = nullptr;
    int diffTargetRow = -1;
+   // The fonts and the elided texts are kept between paints, so scrolling doesn't build them for every cell
+   mutable bool mAreFontsSet = false;
+   mutable QFont mViewFont;
+   mutable QFont mFont;
+   mutable QFont mShaFont;
+   mutable QFont mBoldFont;
+   mutable QCache<QPair<int, int>, ElidedText> mElidedTexts;
+   mutable RefDecorations mDecorations;
+   mutable int mDecorationsRevision = -1;
+   mutable QCache<GlyphKey, QPixmap> mGlyphs;
+   mutable QVector<LaneType> mLanes;
+
+   void updateFonts(const QFont &viewFont) const;
+   QString elidedText(const QModelIndex &index, const QString &text, const QFont &font, int width) const;
+   const RefDecorations &decorations() const;
 
    void paintLog(QPainter *p, const QStyleOptionViewItem &o, const QModelIndex &i) const;
    void paintGraph(QPainter *p, const QStyleOptionViewItem &o, const QModelIndex &index) const;
    void paintGraphLane(QPainter *p, const LaneType type, bool laneHeadPresent, int x1, int x2, const QColor &col,
                        const QColor &activeCol, const QColor &mergeColor, bool isWip = false) const;
-   void paintTagBranch(QPainter *painter, QStyleOptionViewItem opt, int &startPoint, const QString &sha) const;
+   void drawGraphLane(QPainter *p, LaneType type, bool laneHeadPresent, int x1, const QColor &col,
+                      const QColor &activeCol, const QColor &mergeColor, bool isWip) const;
+   void paintTagBranch(QPainter *painter, const QStyleOptionViewItem &opt, int &startPoint,
+                       const QVector<RefDecorations::Pill> &pills) const;
 };